@@ -24,11 +24,15 @@ using std::array;
 using std::copy;
 using std::for_each;
 using std::max_element;
-#include <cmath>
-using std::pow;
 #include <string>
 using std::string;
-using std::to_string;
+#include <memory>
+using std::unique_ptr;
+#include <thread>
+using std::thread;
+#include <type_traits>
+using std::is_integral;
+using std::make_unsigned;
 
 namespace sa
 { // sa = sorting algorithms
@@ -46,12 +50,35 @@ namespace sa
     return oss.str();
   }
 
+  /*!
+   * @brief Maps an integer to an unsigned key with the same order, for the radix sorts.
+   *
+   * The sign bit of signed types is flipped, so negative values come before the positive ones.
+   *
+   * @tparam DataType The integer type of the value.
+   * @param value The value.
+   * @return The unsigned key of the value.
+   */
+  template <typename DataType>
+  typename std::make_unsigned<DataType>::type radix_key(DataType value)
+  {
+    using Key = typename std::make_unsigned<DataType>::type;
+    constexpr Key flip = std::is_signed<DataType>::value ? Key(Key(1) << (8 * sizeof(DataType) - 1)) : Key(0);
+    return Key(value) ^ flip;
+  }
+
   //{{{ RADIX SORT
   /*!
    * @brief Implements the Radix Sorting Algorithm based on the less
-   * significant digit (LSD).
+   * significant digit (LSD), one byte per digit.
    *
-   * @tparam DataType The type of elements that are being sorted.
+   * The histograms of all the bytes are counted in a single pass over the range. Each
+   * pass then scatters the elements by one byte into a scratch buffer allocated once,
+   * and the range and the buffer swap roles (ping-pong). A pass in which every element
+   * has the same byte would not move anything, so it is skipped. Negative values are
+   * sorted too (see radix_key()).
+   *
+   * @tparam DataType The type of elements that are being sorted (an integer type).
    * @tparam Comparator A Comparator type function that returns true if the first
    * argument is less than the second argument.
    *
@@ -63,30 +90,221 @@ namespace sa
   template <typename DataType, typename Comparator>
   void radix(DataType *first, DataType *last, Comparator /*unused*/)
   {
-    // Calculates the number of digits of the largest element in the range
-    size_t n_digits = std::to_string(*std::max_element(first, last)).size();
+    static_assert(std::is_integral<DataType>::value, "radix sorts integer types only");
+    constexpr size_t n_bytes = sizeof(DataType);
 
-    // Iterates over all digits
-    for (size_t i = 0; i < n_digits; i++)
+    size_t n = std::distance(first, last);
+    if (n < 2)
+      return;
+
+    // Counts the occurrences of every value of every byte, in one pass
+    std::array<std::array<size_t, 256>, n_bytes> counts{};
+    for (auto p = first; p != last; p++)
     {
-      std::array<std::vector<DataType>, 10> buckets; // one bucket for each digit from 0 to 9
-      // For each number in the range, calculate the index of the bucket
-      // based on the current digit and place the number in that bucket
-      for (auto p = first; p != last; p++)
+      auto key = radix_key(*p);
+      for (size_t b = 0; b < n_bytes; b++)
+        counts[b][(key >> (8 * b)) & 0xFF]++;
+    }
+
+    // The scratch buffer is not initialized: every pass overwrites it
+    std::unique_ptr<DataType[]> buffer(new DataType[n]);
+    DataType *from = first;
+    DataType *to = buffer.get();
+
+    // Iterates over all bytes, from the least significant one
+    for (size_t b = 0; b < n_bytes; b++)
+    {
+      auto &count = counts[b];
+      // If all the elements have the same byte, the pass would not change their order
+      if (count[(radix_key(*from) >> (8 * b)) & 0xFF] == n)
+        continue;
+
+      // Turns the counts into the position where each bucket starts
+      size_t offset = 0;
+      for (auto &c : count)
       {
-        int index = (int)(*p / std::pow(10, i)) % 10;
-        buckets[index].push_back(*p);
+        size_t c_size = c;
+        c = offset;
+        offset += c_size;
       }
 
-      // Copy the numbers from the buckets back to the original range,
-      // preserving the order of the elements within each bucket
-      auto it = first;
-      for (auto &bucket : buckets)
-        it = std::copy(bucket.begin(), bucket.end(), it);
+      // Scatters the elements by the current byte, preserving the order of the elements within each bucket
+      for (auto p = from; p != from + n; p++)
+        to[count[(radix_key(*p) >> (8 * b)) & 0xFF]++] = *p;
+
+      std::swap(from, to);
     }
+
+    // After an odd number of passes the sorted elements are in the buffer
+    if (from != first)
+      std::copy(from, from + n, first);
   }
   //}}} RADIX SORT
 
+  /*!
+   * @brief Scatters a chunk by one byte of the keys, through one write-combining buffer per bucket.
+   *
+   * The elements of each bucket are gathered in a buffer of one cache line and written
+   * out a full line at a time, so the stores into the 256 buckets do not keep evicting
+   * each other's lines.
+   *
+   * @tparam DataType The type of elements that are being sorted (an integer type).
+   *
+   * @param first Pointer to the beginning of the chunk.
+   * @param last Pointer to the location just past the last valid value of the chunk.
+   * @param to Pointer to the beginning of the destination range.
+   * @param byte The byte of the keys that selects the bucket.
+   * @param offset The position in the destination where the elements of each bucket go next (updated).
+   */
+  template <typename DataType>
+  void radix_scatter(const DataType *first, const DataType *last, DataType *to, size_t byte,
+                     std::array<size_t, 256> &offset)
+  {
+    constexpr size_t line = 64 / sizeof(DataType) > 0 ? 64 / sizeof(DataType) : 1;
+    struct alignas(64) Line
+    {
+      DataType values[line];
+    };
+    std::unique_ptr<Line[]> buffer(new Line[256]);
+    std::array<size_t, 256> used{};
+
+    for (auto p = first; p != last; p++)
+    {
+      size_t d = (radix_key(*p) >> (8 * byte)) & 0xFF;
+      buffer[d].values[used[d]++] = *p;
+      if (used[d] == line)
+      {
+        std::copy(buffer[d].values, buffer[d].values + line, to + offset[d]);
+        offset[d] += line;
+        used[d] = 0;
+      }
+    }
+
+    // Writes out the partial lines
+    for (size_t d = 0; d < 256; d++)
+    {
+      std::copy(buffer[d].values, buffer[d].values + used[d], to + offset[d]);
+      offset[d] += used[d];
+    }
+  }
+
+  //{{{ PARALLEL RADIX SORT
+  /*!
+   * @brief Implements the Radix Sorting Algorithm based on the less significant
+   * digit (LSD), one byte per digit, with the work of each pass split among threads.
+   *
+   * The range is split into one chunk per hardware thread. Each thread counts the
+   * histograms of all the bytes of its chunk, in one pass. For each byte, the histograms
+   * are prefix-summed, bucket by bucket and thread by thread, into the position where
+   * each thread writes its elements of each bucket, so all the threads scatter at once
+   * without synchronization, and the sort stays stable. As in radix(), the range and a
+   * scratch buffer swap roles at each pass, and trivial passes are skipped. Small ranges
+   * are left to radix().
+   *
+   * @tparam DataType The type of elements that are being sorted (an integer type).
+   * @tparam Comparator A Comparator type function that returns true if the first
+   * argument is less than the second argument.
+   *
+   * @param first Pointer/iterator to the beginning of the range we wish to sort.
+   * @param last Pointer/iterator to the location just past the last valid value
+   * of the range we wish to sort.
+   * @param unused An unused parameter of Comparator type.
+   */
+  template <typename DataType, typename Comparator>
+  void parallel_radix(DataType *first, DataType *last, Comparator unused)
+  {
+    static_assert(std::is_integral<DataType>::value, "parallel_radix sorts integer types only");
+    constexpr size_t n_bytes = sizeof(DataType);
+    // Below this size per thread, starting the threads costs more than they save
+    constexpr size_t min_chunk = 1 << 16;
+
+    size_t n = std::distance(first, last);
+    size_t n_threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), n / min_chunk);
+    if (n_threads < 2)
+    {
+      radix(first, last, unused);
+      return;
+    }
+
+    // Runs a task on every chunk, each one on its own thread
+    auto chunk = [&](size_t t) { return first + n * t / n_threads; };
+    auto run = [&](const std::function<void(size_t)> &task)
+    {
+      std::vector<std::thread> threads;
+      for (size_t t = 1; t < n_threads; t++)
+        threads.emplace_back(task, t);
+      task(0);
+      for (auto &thread : threads)
+        thread.join();
+    };
+
+    // Each thread counts the histograms of all the bytes of its chunk
+    std::vector<std::array<std::array<size_t, 256>, n_bytes>> counts(n_threads);
+    run([&](size_t t)
+        {
+          auto &count = counts[t];
+          for (auto &c : count)
+            c.fill(0);
+          for (auto p = chunk(t); p != chunk(t + 1); p++)
+          {
+            auto key = radix_key(*p);
+            for (size_t b = 0; b < n_bytes; b++)
+              count[b][(key >> (8 * b)) & 0xFF]++;
+          } });
+
+    std::unique_ptr<DataType[]> buffer(new DataType[n]);
+    DataType *from = first;
+    DataType *to = buffer.get();
+    std::vector<std::array<size_t, 256>> offsets(n_threads);
+    bool moved = false;
+
+    // Iterates over all bytes, from the least significant one
+    for (size_t b = 0; b < n_bytes; b++)
+    {
+      // If all the elements have the same byte, the pass would not change their order
+      // (the totals of the first counts hold for any split of the range)
+      bool trivial = false;
+      for (size_t d = 0; d < 256 and not trivial; d++)
+      {
+        size_t total = 0;
+        for (size_t t = 0; t < n_threads; t++)
+          total += counts[t][b][d];
+        trivial = total == n;
+      }
+      if (trivial)
+        continue;
+
+      // After the first pass the chunks hold other elements, whose byte is counted again
+      if (moved)
+        run([&](size_t t)
+            {
+              auto &count = counts[t][b];
+              count.fill(0);
+              for (auto p = from + (chunk(t) - first); p != from + (chunk(t + 1) - first); p++)
+                count[(radix_key(*p) >> (8 * b)) & 0xFF]++; });
+
+      // The elements of bucket d from thread t go after those of the smaller buckets,
+      // and after those of bucket d from the previous threads
+      size_t offset = 0;
+      for (size_t d = 0; d < 256; d++)
+        for (size_t t = 0; t < n_threads; t++)
+        {
+          offsets[t][d] = offset;
+          offset += counts[t][b][d];
+        }
+
+      run([&](size_t t)
+          { radix_scatter(from + (chunk(t) - first), from + (chunk(t + 1) - first), to, b, offsets[t]); });
+      moved = true;
+      std::swap(from, to);
+    }
+
+    // After an odd number of passes the sorted elements are in the buffer
+    if (from != first)
+      std::copy(from, from + n, first);
+  }
+  //}}} PARALLEL RADIX SORT
+
   //{{{ INSERTION SORT
   /*!
    * @brief Implements the Insertion Sort algorithm.
@@ -123,6 +341,106 @@ namespace sa
   }
   //}}} INSERTION SORT
 
+  /*!
+   * @brief Permutes a range in place into 256 buckets by one byte of the keys, then sorts each bucket by the next byte.
+   *
+   * @tparam DataType The type of elements that are being sorted (an integer type).
+   *
+   * @param first Pointer/iterator to the beginning of the range we wish to sort.
+   * @param last Pointer/iterator to the location just past the last valid value of the range.
+   * @param byte The byte of the keys that selects the bucket, counted from the least significant one.
+   */
+  template <typename DataType>
+  void american_flag_pass(DataType *first, DataType *last, size_t byte)
+  {
+    // Buckets this small are left to the insertion sort
+    constexpr size_t small_bucket = 32;
+    size_t n = std::distance(first, last);
+    auto digit = [&byte](DataType value) { return (radix_key(value) >> (8 * byte)) & 0xFF; };
+
+    // Counts the elements of each bucket; when all of them fall into one, the next byte is tried
+    std::array<size_t, 256> count;
+    for (;;)
+    {
+      count.fill(0);
+      for (auto p = first; p != last; p++)
+        count[digit(*p)]++;
+      if (count[digit(*first)] != n)
+        break;
+      if (byte == 0)
+        return;
+      byte--;
+    }
+
+    // Each bucket is the range [head, tail) of the array
+    std::array<size_t, 256> head, tail;
+    size_t offset = 0;
+    for (size_t d = 0; d < 256; d++)
+    {
+      head[d] = offset;
+      offset += count[d];
+      tail[d] = offset;
+    }
+
+    // Every element out of its bucket is swapped into the next free place of its own bucket,
+    // which brings out another element, until the element in hand belongs to the current bucket
+    for (size_t d = 0; d < 256; d++)
+    {
+      while (head[d] < tail[d])
+      {
+        DataType value = first[head[d]];
+        size_t v_digit = digit(value);
+        while (v_digit != d)
+        {
+          std::swap(value, first[head[v_digit]++]);
+          v_digit = digit(value);
+        }
+        first[head[d]++] = value;
+      }
+    }
+
+    // Sorts each bucket by the next byte, or by insertion when it is small
+    size_t begin = 0;
+    for (size_t d = 0; d < 256; d++)
+    {
+      if (count[d] > small_bucket && byte > 0)
+        american_flag_pass(first + begin, first + begin + count[d], byte - 1);
+      else if (count[d] > 1)
+        insertion(first + begin, first + begin + count[d], std::less<DataType>());
+      begin += count[d];
+    }
+  }
+
+  //{{{ AMERICAN FLAG SORT
+  /*!
+   * @brief Implements the American Flag Sort, an in-place Radix Sort based on the
+   * most significant digit (MSD), one byte per digit.
+   *
+   * Unlike radix(), no buffer is allocated: the elements are permuted within the range
+   * into the buckets of their most significant byte, and each bucket is sorted in the
+   * same way by the next byte. Small buckets are sorted by insertion. Like radix(), the
+   * elements are sorted in increasing order, negative values included.
+   *
+   * @tparam DataType The type of elements that are being sorted (an integer type).
+   * @tparam Comparator A Comparator type function that returns true if the first
+   * argument is less than the second argument.
+   *
+   * @param first Pointer/iterator to the beginning of the range we wish to sort.
+   * @param last Pointer/iterator to the location just past the last valid value
+   * of the range we wish to sort.
+   * @param unused An unused parameter of Comparator type.
+   */
+  template <typename DataType, typename Comparator>
+  void american_flag(DataType *first, DataType *last, Comparator /*unused*/)
+  {
+    static_assert(std::is_integral<DataType>::value, "american_flag sorts integer types only");
+
+    if (std::distance(first, last) < 2)
+      return;
+    american_flag_pass(first, last, sizeof(DataType) - 1);
+  }
+  //}}} AMERICAN FLAG SORT
+
   //{{{ SELECTION SORT
   /*!
    * @brief Implements the Selection Sort algorithm.
@@ -237,6 +555,8 @@ namespace sa
   /*!
    * @brief Merges two sorted ranges into one.
    *
+   * The merge is stable: of two equivalent elements, the one from the first range comes first.
+   *
    * @tparam DataType The type of elements that are being sorted.
    * @tparam Compare A Comparator type function that returns true if the first
    * argument is less than the second argument.
@@ -258,17 +578,17 @@ namespace sa
     // While there are elements in both left and right intervals
     while (l_first != l_last && r_first != r_last)
     {
-      // If the element from the left interval is smaller, copy it to the original interval
-      if (cmp(*l_first, *r_first))
+      // If the element from the right interval is smaller, copy it to the original interval
+      if (cmp(*r_first, *l_first))
       {
-        *first = *l_first;
-        l_first++;
+        *first = *r_first;
+        r_first++;
       }
       else
       {
-        // Otherwise, copy the element from the right interval
-        *first = *r_first;
-        r_first++;
+        // Otherwise (ties included, which keeps the merge stable), copy the element from the left interval
+        *first = *l_first;
+        l_first++;
       }
       first++;
     }
@@ -339,6 +659,204 @@ namespace sa
   }
   //}}} MERGE SORT
 
+  //{{{ BOTTOM-UP MERGE SORT
+  /*!
+   * @brief Implements the bottom-up (iterative) Merge Sort algorithm.
+   *
+   * Unlike merge(), a single buffer the size of the range is allocated, up front.
+   * Runs of a few elements are first sorted by insertion; then runs of doubling
+   * width are merged pairwise, from the range into the buffer and back (ping-pong),
+   * so each level copies every element once. A pair of runs that is already in
+   * order is copied without merging. The sort is stable.
+   *
+   * @tparam DataType The type of elements that are being sorted.
+   * @tparam Comparator A Comparator type function that returns true if the first
+   * argument is less than the second argument.
+   *
+   * @param first Pointer/iterator to the beginning of the range we wish to sort.
+   * @param last Pointer/iterator to the location just past the last valid value
+   * of the range we wish to sort.
+   * @param cmp A Comparator function object to determine the relative order of elements.
+   */
+  template <typename DataType, typename Compare>
+  void merge_bottom_up(DataType *first, DataType *last, Compare cmp)
+  {
+    // Runs this small are sorted by insertion
+    constexpr size_t small_run = 16;
+    size_t n = std::distance(first, last);
+    if (n < 2)
+      return;
+
+    for (size_t i = 0; i < n; i += small_run)
+      insertion(first + i, first + std::min(i + small_run, n), cmp);
+    if (n <= small_run)
+      return;
+
+    std::unique_ptr<DataType[]> buffer(new DataType[n]);
+    DataType *from = first;
+    DataType *to = buffer.get();
+
+    // Merges the pairs of runs of each width into the other array
+    for (size_t width = small_run; width < n; width *= 2)
+    {
+      for (size_t left = 0; left < n; left += 2 * width)
+      {
+        size_t mid = std::min(left + width, n);
+        size_t right = std::min(left + 2 * width, n);
+        // The runs are in order if the first element of the right run is not smaller than the last of the left one
+        if (mid == right || !cmp(from[mid], from[mid - 1]))
+          std::copy(from + left, from + right, to + left);
+        else
+          merging(from + left, from + mid, from + mid, from + right, to + left, cmp);
+      }
+      std::swap(from, to);
+    }
+
+    // After an odd number of levels the sorted elements are in the buffer
+    if (from != first)
+      std::copy(from, from + n, first);
+  }
+  //}}} BOTTOM-UP MERGE SORT
+
+  /*!
+   * @brief Finds where the merge path of two sorted ranges crosses a given diagonal (co-ranking).
+   *
+   * Of the first k elements of the stable merge of `a` and `b`, returns how many come
+   * from `a`; the other k minus that many are the first ones of `b`.
+   *
+   * @tparam DataType The type of elements that are being sorted.
+   * @tparam Compare A Comparator type function that returns true if the first
+   * argument is less than the second argument.
+   *
+   * @param a Pointer to the first sorted range, of a_size elements.
+   * @param b Pointer to the second sorted range, of b_size elements.
+   * @param k The number of merged elements, at most a_size + b_size.
+   * @param cmp A Comparator function object to determine the relative order of elements.
+   * @return The number of elements of `a` among the first k merged elements.
+   */
+  template <typename DataType, typename Compare>
+  size_t merge_path(const DataType *a, size_t a_size, const DataType *b, size_t b_size, size_t k, Compare cmp)
+  {
+    size_t lo = k > b_size ? k - b_size : 0;
+    size_t hi = std::min(k, a_size);
+    // Taking i elements of a is too few while b[k - i - 1] does not come before a[i]
+    // (ties go to a), and taking more only makes that more likely to hold
+    while (lo < hi)
+    {
+      size_t i = lo + (hi - lo) / 2;
+      if (cmp(b[k - i - 1], a[i]))
+        hi = i;
+      else
+        lo = i + 1;
+    }
+    return lo;
+  }
+
+  //{{{ PARALLEL MERGE SORT
+  /*!
+   * @brief Implements a parallel, stable Merge Sort algorithm.
+   *
+   * The range is split into one chunk per hardware thread, and each chunk is sorted
+   * by merge_bottom_up() on its own thread. Then the sorted runs are merged pairwise,
+   * level by level, between the range and one buffer (ping-pong). At every level, each
+   * merge is split by merge_path() into independent pieces, about n / threads elements
+   * each, so the last merges keep every thread busy too. Small ranges are left to
+   * merge_bottom_up().
+   *
+   * @tparam DataType The type of elements that are being sorted.
+   * @tparam Comparator A Comparator type function that returns true if the first
+   * argument is less than the second argument.
+   *
+   * @param first Pointer/iterator to the beginning of the range we wish to sort.
+   * @param last Pointer/iterator to the location just past the last valid value
+   * of the range we wish to sort.
+   * @param cmp A Comparator function object to determine the relative order of elements.
+   */
+  template <typename DataType, typename Compare>
+  void parallel_merge(DataType *first, DataType *last, Compare cmp)
+  {
+    // Below this size per thread, starting the threads costs more than they save
+    constexpr size_t min_chunk = 1 << 14;
+
+    size_t n = std::distance(first, last);
+    size_t n_threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), n / min_chunk);
+    if (n_threads < 2)
+    {
+      merge_bottom_up(first, last, cmp);
+      return;
+    }
+
+    // Runs a list of tasks, spread round-robin over the threads
+    auto run = [&](const std::vector<std::function<void()>> &tasks)
+    {
+      auto worker = [&](size_t t)
+      {
+        for (size_t i = t; i < tasks.size(); i += n_threads)
+          tasks[i]();
+      };
+      std::vector<std::thread> threads;
+      for (size_t t = 1; t < n_threads; t++)
+        threads.emplace_back(worker, t);
+      worker(0);
+      for (auto &thread : threads)
+        thread.join();
+    };
+
+    // Sorts each chunk; runs[r] is where the r-th sorted run starts
+    std::vector<size_t> runs;
+    std::vector<std::function<void()>> tasks;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+      size_t begin = n * t / n_threads, end = n * (t + 1) / n_threads;
+      runs.push_back(begin);
+      tasks.push_back([=]()
+                      { merge_bottom_up(first + begin, first + end, cmp); });
+    }
+    runs.push_back(n);
+    run(tasks);
+
+    std::unique_ptr<DataType[]> buffer(new DataType[n]);
+    DataType *from = first;
+    DataType *to = buffer.get();
+    size_t piece = (n + n_threads - 1) / n_threads;
+
+    // Merges the pairs of runs of each level into the other array
+    while (runs.size() > 2)
+    {
+      tasks.clear();
+      std::vector<size_t> merged;
+      for (size_t r = 0; r + 1 < runs.size(); r += 2)
+      {
+        size_t left = runs[r];
+        size_t mid = runs[r + 1];
+        size_t right = r + 2 < runs.size() ? runs[r + 2] : mid;
+        merged.push_back(left);
+
+        // Each piece of the output of this merge is produced from its own parts of the two runs
+        DataType *a = from + left, *b = from + mid;
+        size_t a_size = mid - left, b_size = right - mid;
+        for (size_t k = 0; k < a_size + b_size; k += piece)
+        {
+          size_t k_end = std::min(k + piece, a_size + b_size);
+          tasks.push_back([=]()
+                          {
+                            size_t i = merge_path(a, a_size, b, b_size, k, cmp);
+                            size_t i_end = merge_path(a, a_size, b, b_size, k_end, cmp);
+                            merging(a + i, a + i_end, b + (k - i), b + (k_end - i_end), to + left + k, cmp); });
+        }
+      }
+      merged.push_back(n);
+      run(tasks);
+      runs.swap(merged);
+      std::swap(from, to);
+    }
+
+    // After an odd number of levels the sorted elements are in the buffer
+    if (from != first)
+      std::copy(from, from + n, first);
+  }
+  //}}} PARALLEL MERGE SORT
+
   /*!
    * @brief Implements the median-of-three pivot selection strategy for quicksort.
    *
@@ -15,6 +15,8 @@
 #include <functional>
 #include <random>
 #include <numeric>
+#include <limits>
+#include <stdexcept>
 using std::function;
 
 #include "lib/sorting.h"
@@ -57,15 +59,16 @@ void print_diff(const std::chrono::time_point<std::chrono::steady_clock> &start,
 }
 
 
-/// The running options
+/// The running options (the defaults may be changed from the command line).
 struct RunningOptions {
-  constexpr static size_t min_sample_sz{100};   //!< Minimum sample size.
-  constexpr static size_t max_sample_sz{100000}; //!< Maximum sample size.
-  constexpr static int n_samples{25};      //!< The number of samples to collect.
-  constexpr static short n_runs{5};       //!< How many runs per average.
+  size_t min_sample_sz{100};   //!< Minimum sample size.
+  size_t max_sample_sz{100000}; //!< Maximum sample size.
+  int n_samples{25};      //!< The number of samples to collect.
+  short n_runs{5};       //!< How many runs per average.
+  std::vector<std::string> algorithms; //!< Names of the algorithms to run (all of them, if empty).
   ///Returns the sample size step, based on the `[min,max]` sample sizes and # of samples.
-  static size_type sample_step() {
-    return static_cast<float>(max_sample_sz - min_sample_sz) / (n_samples - 1);
+  size_type sample_step() const {
+    return n_samples > 1 ? static_cast<double>(max_sample_sz - min_sample_sz) / (n_samples - 1) : 0;
   }
 };
 
@@ -151,21 +154,20 @@ void all_random(value_type* first, value_type* last, double /*unused*/){
 /// @param last Pointer/iterator to the location just past the last valid value of the range to be shuffled.
 /// @param percent The percentage of elements to be shuffled.
 void percent_random(value_type* first, value_type* last, double percent){
-  int n = last - first;
+  size_type n = last - first;
 
-  int I[n];
-
-  for(int i = 0; i < n; i++)
-      I[i] = i;
+  // The indices are on the heap: large samples would overflow the stack
+  std::vector<size_type> I(n);
+  std::iota(I.begin(), I.end(), 0);
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
-    std::shuffle(I, I + n, gen);
+    std::shuffle(I.begin(), I.end(), gen);
 
     auto p = percent * n;
 
-    for(int i = 0; i <= p; i+=2)
+    for(size_type i = 0; i <= p and i + 1 < n; i+=2)
        std::swap(first[I[i]], first[I[i+1]]);
 }
 
@@ -216,43 +218,43 @@ struct SortingCollection{
 /// This struct is used to manage different scenarios in a sorting process.
 struct DataSet{
   int curr_dataset = 0; //!< Current scenario/dataset being processed
-  static const int max_size = 100000; //!< Maximum size of the dataset.
-  value_type arr[max_size]; //!< Array containing the data.
-  value_type arr_copy[max_size]; //!< Copy of the original array.
+  size_type max_size; //!< Maximum size of the dataset.
+  std::vector<value_type> arr; //!< Array containing the data.
+  std::vector<value_type> arr_copy; //!< Copy of the original array.
   std::vector<Scenario> scenarios; //!< Collection of scenarios.
 
-  int curr_size; //!< Current size of the dataset.
+  size_type curr_size; //!< Current size of the dataset.
 
   /// @brief Constructor for the DataSet.
   ///
   /// @param input Collection of Scenario objects.
-  DataSet (std::vector<Scenario> input) : scenarios(input) {
-    for(int i = 0; i < max_size; i++)
-      arr[i] = i + 1;
+  /// @param size Maximum size of the dataset.
+  DataSet (std::vector<Scenario> input, size_type size) : max_size(size), arr(size), arr_copy(size), scenarios(input) {
+    std::iota(arr.begin(), arr.end(), 1);
   }
 
   /// @brief Sets the current scenario and applies its function to the data set.
   ///
   /// @param size Size of the data set for the current scenario.
-  void set_scenario(int size) {
+  void set_scenario(size_type size) {
     curr_size = size;
 
     Scenario organizer = scenarios[curr_dataset];
     if(organizer.name == "ALL_RANDOM" || organizer.name == "ASCENDING_ORDER" || organizer.name == "DESCENDING_ORDER")
-      organizer.func(arr, arr + curr_size, pattern);
+      organizer.func(begin_data(), end_data(), pattern);
     else if(organizer.name == "RANDOM_25")
-      organizer.func(arr, arr + curr_size, 0.25);
+      organizer.func(begin_data(), end_data(), 0.25);
     else if(organizer.name == "RANDOM_50")
-      organizer.func(arr, arr + curr_size, 0.50);
+      organizer.func(begin_data(), end_data(), 0.50);
     else if(organizer.name == "RANDOM_75")
-      organizer.func(arr, arr + curr_size, 0.75);
+      organizer.func(begin_data(), end_data(), 0.75);
     
-    std::copy(arr, arr + curr_size, arr_copy);
+    std::copy(begin_data(), end_data(), arr_copy.begin());
   }
 
   /// @brief Resets the dataset to the configuration of the current scenario.
   void reset(){
-    std::copy(arr_copy, arr_copy + curr_size, arr);
+    std::copy(arr_copy.begin(), arr_copy.begin() + curr_size, arr.begin());
   }
 
   /// @brief Returns the name of the current scenario.
@@ -278,19 +280,19 @@ struct DataSet{
   ///
   /// @return Pointer to the beginning of the data set.
   value_type* begin_data() {
-    return arr;
+    return arr.data();
   }
   
   /// @brief Returns a pointer to the end of the current data set.
   ///
   /// @return Pointer to the end of the current data set.
   value_type* end_data() {
-    return arr + curr_size;
+    return arr.data() + curr_size;
   }
 
   /// @brief Prints the current data set.
   void imprimir(){
-    for(int i=0; i<curr_size; i++){
+    for(size_type i=0; i<curr_size; i++){
       std::cout << arr[i] << ' ';
     }
   }
@@ -331,12 +333,90 @@ Algorithm SHELL {"SHELL_SORT", sa::shell<value_type, Comparator>};
 /// Merge sort algorithm.
 Algorithm MERGE {"MERGE_SORT", sa::merge<value_type, Comparator>};
 
+/// Bottom-up merge sort algorithm (single buffer).
+Algorithm MERGE_BOTTOM_UP {"MERGE_BOTTOM_UP_SORT", sa::merge_bottom_up<value_type, Comparator>};
+
 /// Quick sort algorithm.
 Algorithm QUICK {"QUICK_SORT", sa::quick<value_type, Comparator>};
 
 /// Radix sort algorithm.
 Algorithm RADIX {"RADIX_SORT", sa::radix<value_type, Comparator>};
 
+/// In-place (American flag) radix sort algorithm.
+Algorithm AMERICAN_FLAG {"AMERICAN_FLAG_SORT", sa::american_flag<value_type, Comparator>};
+
+/// Parallel radix sort algorithm.
+Algorithm PARALLEL_RADIX {"PARALLEL_RADIX_SORT", sa::parallel_radix<value_type, Comparator>};
+
+/// Parallel merge sort algorithm.
+Algorithm PARALLEL_MERGE {"PARALLEL_MERGE_SORT", sa::parallel_merge<value_type, Comparator>};
+
+/// @brief Reads the running options from the command line.
+///
+/// Options are given as `--name=value`: `--min`, `--max` (sample sizes), `--samples`, `--runs`,
+/// and `--algs`, a comma-separated list of algorithm names (e.g. `--algs=MERGE_SORT,PARALLEL_MERGE_SORT`).
+///
+/// @param argc The number of command-line arguments.
+/// @param argv An array of command-line arguments.
+/// @return The running options.
+RunningOptions parse_options(int argc, char* argv[]){
+  auto usage = [&](){
+    std::cerr << "Usage: " << argv[0] << " [--min=N] [--max=N] [--samples=N] [--runs=N] [--algs=NAME,...]\n";
+    std::exit(EXIT_FAILURE);
+  };
+  // Converts the whole value to an integer in [low, high], or stops with the usage message
+  auto to_number = [&](const std::string &name, const std::string &value, long long low, long long high){
+    long long number = 0;
+    size_t used = 0;
+    try {
+      number = std::stoll(value, &used);
+    } catch(const std::logic_error &){ // invalid_argument or out_of_range
+      used = 0;
+    }
+    if(value.empty() or used != value.size() or number < low or number > high){
+      std::cerr << "Invalid value for " << name << ": " << value << " (an integer in [" << low << ", " << high << "])\n";
+      usage();
+    }
+    return number;
+  };
+
+  RunningOptions run;
+  for(int i = 1; i < argc; i++){
+    std::string arg{argv[i]};
+    auto eq = arg.find('=');
+    std::string name = arg.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if(name == "--min")
+      run.min_sample_sz = to_number(name, value, 1, std::numeric_limits<size_type>::max());
+    else if(name == "--max")
+      run.max_sample_sz = to_number(name, value, 1, std::numeric_limits<size_type>::max());
+    else if(name == "--samples")
+      run.n_samples = to_number(name, value, 1, std::numeric_limits<int>::max());
+    else if(name == "--runs")
+      run.n_runs = to_number(name, value, 1, std::numeric_limits<short>::max());
+    else if(name == "--algs"){
+      // an empty list would select every algorithm, so blank names are rejected
+      std::istringstream names{value};
+      for(std::string alg; std::getline(names, alg, ',');)
+        run.algorithms.push_back(alg);
+      bool blank = run.algorithms.empty() or value.back() == ',';
+      for(const auto &alg : run.algorithms)
+        blank = blank or alg.find_first_not_of(" \t") == std::string::npos;
+      if(blank){
+        std::cerr << "Invalid value for " << name << ": " << value << " (a comma-separated list of algorithm names)\n";
+        usage();
+      }
+    }
+    else
+      usage();
+  }
+  if(run.max_sample_sz < run.min_sample_sz){
+    std::cerr << "Invalid options: the sizes must satisfy min <= max.\n";
+    usage();
+  }
+  return run;
+}
+
 
 /// @brief The main function, entry point.
 /// @param argc The number of command-line arguments.
@@ -344,14 +424,27 @@ Algorithm RADIX {"RADIX_SORT", sa::radix<value_type, Comparator>};
 /// @return An integer representing the exit status of the program.
 int main( int argc, char * argv[] ){
 
-    /// Initializes a DataSet with multiple scenarios for sorting.
-    DataSet dataset ({ASCENDING_ORDER, DESCENDING_ORDER, ALL_RANDOM, RANDOM_25, RANDOM_50, RANDOM_75}); 
-    
     ///Initializes RunningOptions which holds the various options for how the sorting algorithm analysis should run.
-    RunningOptions run; 
+    RunningOptions run = parse_options(argc, argv);
+
+    /// Initializes a DataSet with multiple scenarios for sorting.
+    DataSet dataset ({ASCENDING_ORDER, DESCENDING_ORDER, ALL_RANDOM, RANDOM_25, RANDOM_50, RANDOM_75}, run.max_sample_sz);
 
     ///Initializes a SortingCollection with a set of sorting algorithms to be tested on the datasets.
-    SortingCollection sort_algs({BUBBLE, SELECTION, INSERTION, RADIX}); 
+    std::vector<Algorithm> algorithms{BUBBLE, SELECTION, INSERTION, MERGE, MERGE_BOTTOM_UP, PARALLEL_MERGE, RADIX, AMERICAN_FLAG, PARALLEL_RADIX};
+    if(not run.algorithms.empty()){
+      std::vector<Algorithm> selected;
+      for(const auto &name : run.algorithms){
+        auto alg = std::find_if(algorithms.begin(), algorithms.end(), [&](const Algorithm &a){ return a.name == name; });
+        if(alg == algorithms.end()){
+          std::cerr << "Unknown algorithm: " << name << "\n";
+          return EXIT_FAILURE;
+        }
+        selected.push_back(*alg);
+      }
+      algorithms = selected;
+    }
+    SortingCollection sort_algs(algorithms);
 
     // FOR EACH DATA SCENARIO DO...
     while(not dataset.has_ended()){
@@ -368,7 +461,7 @@ int main( int argc, char * argv[] ){
         for ( auto ns{0} ; ns < run.n_samples ; ++ns ){
 
           // Calculate the current size of the tested sample
-          int current_size = run.min_sample_sz + (sample_step * ns);  
+          size_type current_size = run.min_sample_sz + (sample_step * ns);  
           // Reset the algorithm counter
           sort_algs.reset();
 
@@ -5,6 +5,8 @@
 
 #include <utility>
 
+#include "hash_mix.h"
+
 /// Basic constructor.
 Account::Account(std::string n, int bnc, int brc, int nmr, float bal)
     : m_name{std::move( n )}, m_bank_code{ bnc }, m_branch_code{ brc }, m_number{ nmr }, m_balance{ bal }
@@ -17,6 +19,12 @@ Account::AcctKey Account::getKey() const
     return std::make_tuple(m_name, m_bank_code, m_branch_code, m_number);
 }
 
+/// Returns a view of the account key.
+Account::AcctKeyView Account::getKeyView() const
+{
+    return AcctKeyView(m_name, m_bank_code, m_branch_code, m_number);
+}
+
 std::ostream& operator<<(std::ostream& os_, const Account::AcctKey& ak_)
 {
     const auto& [name, bkid, brid, accn] = ak_;
@@ -46,6 +54,34 @@ std::size_t KeyHash::operator()(const Account::AcctKey& k_) const
            xor std::hash<int>{}(accn);
 }
 
+std::size_t KeyHash::operator()(const Account::AcctKeyView& k_) const
+{
+    const auto& [name, bkid, brid, accn] = k_;
+    return std::hash<std::string>{}(name) xor std::hash<int>{}(bkid) xor std::hash<int>{}(brid)
+           xor std::hash<int>{}(accn);
+}
+
+/// Keyed hash of the fields of a key.
+static std::size_t seeded_hash(const std::string& name, int bkid, int brid, int accn, std::uint64_t seed)
+{
+    std::uint64_t h = ac::siphash24(name.data(), name.size(), seed, ac::mix64(seed));
+    h = ac::mix64(h ^ static_cast<std::uint32_t>(bkid), seed);
+    h = ac::mix64(h ^ static_cast<std::uint32_t>(brid), seed);
+    return ac::mix64(h ^ static_cast<std::uint32_t>(accn), seed);
+}
+
+std::size_t KeyHash::operator()(const Account::AcctKey& k_, std::uint64_t seed_) const
+{
+    const auto& [name, bkid, brid, accn] = k_;
+    return seeded_hash(name, bkid, brid, accn, seed_);
+}
+
+std::size_t KeyHash::operator()(const Account::AcctKeyView& k_, std::uint64_t seed_) const
+{
+    const auto& [name, bkid, brid, accn] = k_;
+    return seeded_hash(name, bkid, brid, accn, seed_);
+}
+
 // Functor that test two keys for equality.
 bool KeyEqual::operator()(const Account::AcctKey& k1_, const Account::AcctKey& k2_) const
 {
@@ -53,3 +89,10 @@ bool KeyEqual::operator()(const Account::AcctKey& k1_, const Account::AcctKey& k
     const auto& [name2, bkid2, brid2, accn2] = k2_;
     return name1 == name2 and bkid1 == bkid2 and brid1 == brid2 and accn1 == accn2;
 }
+
+bool KeyEqual::operator()(const Account::AcctKeyView& k1_, const Account::AcctKeyView& k2_) const
+{
+    const auto& [name1, bkid1, brid1, accn1] = k1_;
+    const auto& [name2, bkid2, brid2, accn2] = k2_;
+    return name1 == name2 and bkid1 == bkid2 and brid1 == brid2 and accn1 == accn2;
+}
@@ -6,6 +6,7 @@
 #ifndef ACCOUNT_H
 #define ACCOUNT_H
 
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <tuple>
@@ -20,6 +21,8 @@ struct Account {
 
     // Nickname for the account key.
     using AcctKey = std::tuple<std::string, int, int, int>;
+    // Nickname for a key that refers to the client name stored in the account, instead of copying it.
+    using AcctKeyView = std::tuple<const std::string&, int, int, int>;
 
     /// Basic constructor.
     Account(std::string = "<empty>", int = 0, int = 0, int = 0, float = 0.f);
@@ -27,6 +30,9 @@ struct Account {
     /// Returns the account key.
     [[nodiscard]] AcctKey getKey() const;
 
+    /// Returns a view of the account key (valid while the account exists).
+    [[nodiscard]] AcctKeyView getKeyView() const;
+
     /// Stream extractor of the account information.
     friend std::ostream& operator<<(std::ostream& os, const Account& acct);
 };
@@ -37,11 +43,21 @@ bool operator==(const Account& a, const Account& b);
 /// Functor that generates a hash number for a given account.
 struct KeyHash {
     std::size_t operator()(const Account::AcctKey&) const;
+    std::size_t operator()(const Account::AcctKeyView&) const;
+    /// Keyed hashes (SipHash of the name), whose collisions cannot be predicted without the seed.
+    std::size_t operator()(const Account::AcctKey&, std::uint64_t seed) const;
+    std::size_t operator()(const Account::AcctKeyView&, std::uint64_t seed) const;
 };
 
 // Functor that test two keys for equality.
 struct KeyEqual {
     bool operator()(const Account::AcctKey&, const Account::AcctKey&) const;
+    bool operator()(const Account::AcctKeyView&, const Account::AcctKeyView&) const;
+};
+
+/// Functor that extracts the key view from an account (projection used by `ac::HashSet`).
+struct KeyOfAccount {
+    Account::AcctKeyView operator()(const Account& acct) const { return acct.getKeyView(); }
 };
 
 #endif
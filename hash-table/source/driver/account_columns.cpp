@@ -0,0 +1,284 @@
+/*!
+ * @file: account_columns.cpp
+ */
+#include "account_columns.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+// The kernels below process four rows per instruction with SSE2 (always available on x86-64).
+// Other targets use the plain loops. Float partial sums are folded into a double every BLOCK
+// rows, to bound the rounding error of long sums.
+constexpr std::size_t BLOCK = 1024;
+
+/// Sum of the balances whose bank matches (or of all balances if `all` is true).
+double masked_sum(const int* bank, const float* bal, std::size_t n, int b, bool all)
+{
+    double sum = 0;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i key = _mm_set1_epi32(b);
+    const __m128i every = _mm_set1_epi32(all ? -1 : 0);
+    while (i + 4 <= n) {
+        __m128 acc = _mm_setzero_ps();
+        std::size_t end = std::min(n - n % 4, i + BLOCK);
+        for (; i < end; i += 4) {
+            __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bank + i));
+            __m128 mask = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(codes, key), every));
+            acc = _mm_add_ps(acc, _mm_and_ps(mask, _mm_loadu_ps(bal + i)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        sum += double(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+    for (; i < n; ++i)
+        if (all or bank[i] == b)
+            sum += bal[i];
+    return sum;
+}
+
+/// Sums the balances of each of the `k` codes in `codes` (at most GROUP of them) into `sums`, in one
+/// pass: each group of four rows is compared against every code, one accumulator per code.
+constexpr std::size_t GROUP = 8;
+void grouped_sums(const int* bank, const float* bal, std::size_t n, const int* codes, std::size_t k,
+                  double* sums)
+{
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    // the accumulators and the codes stay in registers (16 XMM registers on x86-64)
+    __m128i key[GROUP];
+    for (std::size_t c = 0; c < k; ++c)
+        key[c] = _mm_set1_epi32(codes[c]);
+    while (i + 4 <= n) {
+        __m128 acc[GROUP];
+        for (std::size_t c = 0; c < k; ++c)
+            acc[c] = _mm_setzero_ps();
+        std::size_t end = std::min(n - n % 4, i + BLOCK);
+        for (; i < end; i += 4) {
+            __m128i row_codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bank + i));
+            __m128 x = _mm_loadu_ps(bal + i);
+            for (std::size_t c = 0; c < k; ++c) {
+                __m128 mask = _mm_castsi128_ps(_mm_cmpeq_epi32(row_codes, key[c]));
+                acc[c] = _mm_add_ps(acc[c], _mm_and_ps(mask, x));
+            }
+        }
+        for (std::size_t c = 0; c < k; ++c) {
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc[c]);
+            sums[c] += double(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        for (std::size_t c = 0; c < k; ++c)
+            if (bank[i] == codes[c])
+                sums[c] += bal[i];
+}
+
+/// Smallest balance (or largest, if `largest`) among the rows of a bank.
+float masked_extreme(const int* bank, const float* bal, std::size_t n, int b, bool largest)
+{
+    const float none = largest ? -std::numeric_limits<float>::infinity()
+                               : std::numeric_limits<float>::infinity();
+    float result = none;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i key = _mm_set1_epi32(b);
+    const __m128 fill = _mm_set1_ps(none);
+    __m128 acc = fill;
+    for (; i + 4 <= n; i += 4) {
+        __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bank + i));
+        __m128 mask = _mm_castsi128_ps(_mm_cmpeq_epi32(codes, key));
+        // rows of other banks are replaced by the neutral value
+        __m128 x = _mm_or_ps(_mm_and_ps(mask, _mm_loadu_ps(bal + i)), _mm_andnot_ps(mask, fill));
+        acc = largest ? _mm_max_ps(acc, x) : _mm_min_ps(acc, x);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    for (auto x : lanes)
+        result = largest ? std::max(result, x) : std::min(result, x);
+#endif
+    for (; i < n; ++i)
+        if (bank[i] == b)
+            result = largest ? std::max(result, bal[i]) : std::min(result, bal[i]);
+    return result;
+}
+} // namespace
+
+/// Inserts an account, replacing the account with the same key.
+bool AccountColumns::insert(const Account& acct)
+{
+    PackedKey key = pack_key(acct, m_names);
+    size_type row;
+    if (m_rows.retrieve(key, row)) {
+        m_balance[row] = acct.m_balance;
+        return false;
+    }
+
+    m_rows.insert(key, m_balance.size());
+    m_name.push_back(key.m_name_id);
+    m_bank.push_back(acct.m_bank_code);
+    m_branch.push_back(acct.m_branch_code);
+    m_number.push_back(acct.m_number);
+    m_balance.push_back(acct.m_balance);
+    return true;
+}
+
+/// Removes an account.
+bool AccountColumns::erase(const key_type& key)
+{
+    PackedKey packed;
+    size_type row;
+    if (not find_row(key, packed, row))
+        return false;
+    m_rows.erase(packed);
+
+    // moves the last row into the erased one, so the columns stay contiguous
+    size_type last = m_balance.size() - 1;
+    if (row != last) {
+        m_name[row] = m_name[last];
+        m_bank[row] = m_bank[last];
+        m_branch[row] = m_branch[last];
+        m_number[row] = m_number[last];
+        m_balance[row] = m_balance[last];
+        m_rows.at(PackedKey::pack(m_name[row], m_bank[row], m_branch[row], m_number[row])) = row;
+    }
+
+    m_name.pop_back();
+    m_bank.pop_back();
+    m_branch.pop_back();
+    m_number.pop_back();
+    m_balance.pop_back();
+    return true;
+}
+
+/// Retrieves an account by key.
+bool AccountColumns::retrieve(const key_type& key, Account& acct) const
+{
+    PackedKey packed;
+    size_type row;
+    if (not find_row(key, packed, row))
+        return false;
+    acct = Account(m_names.name(m_name[row]), m_bank[row], m_branch[row], m_number[row], m_balance[row]);
+    return true;
+}
+
+/// Finds the packed key and the row of a key.
+bool AccountColumns::find_row(const key_type& key, PackedKey& packed, size_type& row) const
+{
+    try {
+        // an unknown name or a code that does not fit a field means no row holds the key
+        return find_key(key, m_names, packed) and m_rows.retrieve(packed, row);
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+}
+
+/// Sum of all balances.
+double AccountColumns::sum_balance() const
+{
+    return masked_sum(m_bank.data(), m_balance.data(), size(), 0, true);
+}
+
+/// Sum of the balances of a bank.
+double AccountColumns::sum_balance(int bank) const
+{
+    return masked_sum(m_bank.data(), m_balance.data(), size(), bank, false);
+}
+
+/// Smallest balance of a bank.
+float AccountColumns::min_balance(int bank) const
+{
+    return masked_extreme(m_bank.data(), m_balance.data(), size(), bank, false);
+}
+
+/// Largest balance of a bank.
+float AccountColumns::max_balance(int bank) const
+{
+    return masked_extreme(m_bank.data(), m_balance.data(), size(), bank, true);
+}
+
+/// Sum of the balances grouped by bank.
+std::map<int, double> AccountColumns::sum_balance_by_bank() const
+{
+    std::map<int, double> result;
+    if (empty())
+        return result;
+
+    // bank codes fit the 16 bits of a PackedKey field, so first find which codes occur in a dense array
+    int hi = *std::max_element(m_bank.begin(), m_bank.end());
+    std::vector<bool> seen(hi + 1, false);
+    for (int b : m_bank)
+        seen[b] = true;
+    std::vector<int> codes;
+    for (int b = 0; b <= hi; ++b)
+        if (seen[b])
+            codes.push_back(b);
+
+    if (codes.size() <= 4 * GROUP) {
+        // few codes: masked SIMD sums, GROUP codes per pass over the columns
+        std::vector<double> sums(codes.size(), 0.0);
+        for (size_type c = 0; c < codes.size(); c += GROUP)
+            grouped_sums(m_bank.data(), m_balance.data(), size(), codes.data() + c,
+                         std::min(GROUP, codes.size() - c), sums.data() + c);
+        for (size_type c = 0; c < codes.size(); ++c)
+            result[codes[c]] = sums[c];
+    } else {
+        // many codes: one accumulator per code, in a dense array (a scatter, which SSE2 lacks)
+        std::vector<double> sums(hi + 1, 0.0);
+        for (size_type i = 0; i < size(); ++i)
+            sums[m_bank[i]] += m_balance[i];
+        for (int b : codes)
+            result[b] = sums[b];
+    }
+    return result;
+}
+
+/// Histogram of the balances.
+std::vector<AccountColumns::size_type> AccountColumns::balance_histogram(float low, float high,
+                                                                         size_type n_bins) const
+{
+    std::vector<size_type> bins(n_bins, 0);
+    if (n_bins == 0 or not(low < high))
+        return bins;
+
+    // the bins of a few balances are computed together (no dependency between them), then counted;
+    // the counting stays scalar, since SSE2 has no scatter
+    const float scale = static_cast<float>(n_bins) / (high - low);
+    const size_type n = size();
+    constexpr size_type LANES = 8;
+    alignas(16) int idx[LANES];
+    for (size_type i = 0; i < n; i += LANES) {
+        size_type m = std::min(LANES, n - i);
+        size_type j = 0;
+#if defined(__SSE2__)
+        // balances outside [low, high) (or NaN) get the bin -1
+        const __m128 vlow = _mm_set1_ps(low);
+        const __m128 vhigh = _mm_set1_ps(high);
+        const __m128 vscale = _mm_set1_ps(scale);
+        const __m128i none = _mm_set1_epi32(-1);
+        for (; j + 4 <= m; j += 4) {
+            __m128 x = _mm_loadu_ps(m_balance.data() + i + j);
+            __m128i in = _mm_castps_si128(_mm_and_ps(_mm_cmpge_ps(x, vlow), _mm_cmplt_ps(x, vhigh)));
+            __m128i bin = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(x, vlow), vscale));
+            bin = _mm_or_si128(_mm_and_si128(in, bin), _mm_andnot_si128(in, none));
+            _mm_store_si128(reinterpret_cast<__m128i*>(idx + j), bin);
+        }
+#endif
+        for (; j < m; ++j) {
+            float x = m_balance[i + j];
+            idx[j] = (x >= low and x < high) ? static_cast<int>((x - low) * scale) : -1;
+        }
+        for (j = 0; j < m; ++j)
+            if (idx[j] >= 0)
+                ++bins[std::min<size_type>(idx[j], n_bins - 1)];
+    }
+    return bins;
+}
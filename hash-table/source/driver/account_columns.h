@@ -0,0 +1,66 @@
+/*!
+ * @brief Columnar (structure-of-arrays) account store with fast balance aggregations.
+ * @file account_columns.h
+ */
+
+#ifndef ACCOUNT_COLUMNS_H
+#define ACCOUNT_COLUMNS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../include/hashtbl.h"
+#include "account.h"
+#include "packed_key.h"
+
+/// Stores each account field in its own contiguous column; a hash table maps each key to its row.
+/// Client names are interned in a NamePool, so the name column holds 32-bit ids and the row lookups
+/// hash and compare PackedKey integers only.
+/// The aggregations scan only the columns they need, processing several rows per instruction of the
+/// CPU (SSE2 kernels on x86-64, plain loops elsewhere).
+class AccountColumns {
+public:
+    using key_type = Account::AcctKey;
+    using size_type = std::size_t;
+
+    /// Inserts an account, replacing the account with the same key. Returns true for new accounts.
+    /// Throws std::out_of_range if a code does not fit a PackedKey field.
+    bool insert(const Account& acct);
+
+    /// Removes an account (the last row takes its place). Returns false if the key is unknown.
+    bool erase(const key_type& key);
+
+    /// Retrieves an account by key. Returns false if the key is unknown.
+    bool retrieve(const key_type& key, Account& acct) const;
+
+    [[nodiscard]] size_type size() const { return m_balance.size(); }
+    [[nodiscard]] bool empty() const { return m_balance.empty(); }
+
+    /// Sum of all balances.
+    [[nodiscard]] double sum_balance() const;
+    /// Sum of the balances of a bank.
+    [[nodiscard]] double sum_balance(int bank) const;
+    /// Smallest balance of a bank (+infinity if the bank has no accounts).
+    [[nodiscard]] float min_balance(int bank) const;
+    /// Largest balance of a bank (-infinity if the bank has no accounts).
+    [[nodiscard]] float max_balance(int bank) const;
+    /// Sum of the balances grouped by bank.
+    [[nodiscard]] std::map<int, double> sum_balance_by_bank() const;
+    /// Number of balances in each of `n_bins` equal bins over `[low, high)`; other balances are ignored.
+    [[nodiscard]] std::vector<size_type> balance_histogram(float low, float high, size_type n_bins) const;
+
+private:
+    /// Finds the packed key and the row of a key. Returns false if no row holds the key.
+    bool find_row(const key_type& key, PackedKey& packed, size_type& row) const;
+
+    NamePool m_names;                      //!< Client names (kept after their accounts are erased).
+    std::vector<NamePool::id_type> m_name; //!< Client name ids.
+    std::vector<int> m_bank;               //!< Bank ids.
+    std::vector<int> m_branch;             //!< Branch ids.
+    std::vector<int> m_number;             //!< Account numbers.
+    std::vector<float> m_balance;          //!< Account balances.
+    ac::HashTbl<PackedKey, size_type, PackedKeyHash, PackedKeyEqual> m_rows; //!< Row of each key.
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*!
+ * @file: account_store.cpp
+ */
+#include "account_store.h"
+
+#include <stdexcept>
+
+/// Inserts an account, replacing the account with the same key.
+bool AccountStore::insert(const Account& acct)
+{
+    if (not valid_balance(acct.m_balance))
+        return false;
+
+    Account old;
+    bool existed = m_accounts.retrieve(acct.getKey(), old);
+    if (existed)
+        unindex(old);
+
+    m_accounts.insert(acct.getKey(), acct);
+    index(acct);
+    return not existed;
+}
+
+/// Replaces an existing account.
+bool AccountStore::update(const Account& acct)
+{
+    if (not valid_balance(acct.m_balance))
+        return false;
+
+    Account old;
+    if (not m_accounts.retrieve(acct.getKey(), old))
+        return false;
+
+    unindex(old);
+    m_accounts.insert(acct.getKey(), acct);
+    index(acct);
+    return true;
+}
+
+/// Removes an account.
+bool AccountStore::erase(const key_type& key)
+{
+    Account old;
+    if (not m_accounts.retrieve(key, old))
+        return false;
+
+    unindex(old);
+    m_accounts.erase(key);
+    return true;
+}
+
+/// Retrieves an account by key.
+bool AccountStore::retrieve(const key_type& key, Account& acct) const
+{
+    return m_accounts.retrieve(key, acct);
+}
+
+/// All accounts of a bank.
+std::vector<Account> AccountStore::by_bank(int bank) const
+{
+    // the stored set is walked in place, rather than copied out of the index
+    try {
+        return collect(m_by_bank.at(bank));
+    } catch (const std::out_of_range&) {
+        return {};
+    }
+}
+
+/// All accounts of a branch of a bank.
+std::vector<Account> AccountStore::by_branch(int bank, int branch) const
+{
+    try {
+        return collect(m_by_branch.at(branch_key(bank, branch)));
+    } catch (const std::out_of_range&) {
+        return {};
+    }
+}
+
+/// All accounts whose balance lies in [low, high].
+std::vector<Account> AccountStore::by_balance(float low, float high) const
+{
+    std::vector<Account> result;
+    for (auto it = m_by_balance.lower_bound(low); it != m_by_balance.end() and it->first <= high; ++it) {
+        // every indexed key is in the primary table; a missing one is skipped rather than made up
+        Account acct;
+        if (m_accounts.retrieve(it->second, acct))
+            result.push_back(acct);
+    }
+    return result;
+}
+
+/// Adds an account to the secondary indexes.
+void AccountStore::index(const Account& acct)
+{
+    auto key = acct.getKey();
+    m_by_bank[acct.m_bank_code].insert(key);
+    m_by_branch[branch_key(acct.m_bank_code, acct.m_branch_code)].insert(key);
+    m_by_balance.emplace(acct.m_balance, key);
+}
+
+/// Removes an account from the secondary indexes.
+void AccountStore::unindex(const Account& acct)
+{
+    auto key = acct.getKey();
+
+    // empty groups are dropped, so the indexes do not keep growing
+    auto& bank = m_by_bank.at(acct.m_bank_code);
+    bank.erase(key);
+    if (bank.empty())
+        m_by_bank.erase(acct.m_bank_code);
+
+    auto bk = branch_key(acct.m_bank_code, acct.m_branch_code);
+    auto& branch = m_by_branch.at(bk);
+    branch.erase(key);
+    if (branch.empty())
+        m_by_branch.erase(bk);
+
+    auto [first, last] = m_by_balance.equal_range(acct.m_balance);
+    for (auto it = first; it != last; ++it) {
+        if (KeyEqual{}(it->second, key)) {
+            m_by_balance.erase(it);
+            break;
+        }
+    }
+}
+
+/// Collects the accounts with the given keys.
+std::vector<Account> AccountStore::collect(const std::set<key_type>& keys) const
+{
+    std::vector<Account> result;
+    result.reserve(keys.size());
+    for (const auto& key : keys) {
+        Account acct;
+        m_accounts.retrieve(key, acct);
+        result.push_back(acct);
+    }
+    return result;
+}
+
+/// Key of the (bank, branch) index.
+long long AccountStore::branch_key(int bank, int branch)
+{
+    return (static_cast<long long>(bank) << 32) | static_cast<unsigned int>(branch);
+}
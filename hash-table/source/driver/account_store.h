@@ -0,0 +1,69 @@
+/*!
+ * @brief Account table with secondary indexes kept in sync with the primary table.
+ * @file account_store.h
+ */
+
+#ifndef ACCOUNT_STORE_H
+#define ACCOUNT_STORE_H
+
+#include <cmath>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../include/hashtbl.h"
+#include "account.h"
+
+/// Stores accounts by key and indexes them by bank, by bank and branch, and by balance.
+/// Every insert, update and erase keeps the indexes in sync, so queries by those fields
+/// run in time proportional to the size of the result.
+class AccountStore {
+public:
+    using key_type = Account::AcctKey;
+    using size_type = std::size_t;
+
+    /// Inserts an account, replacing the account with the same key. Returns true for new accounts,
+    /// and false for replaced ones or (changing nothing) if the balance is not finite.
+    bool insert(const Account& acct);
+
+    /// Replaces an existing account. Returns false (and changes nothing) if the key is unknown or
+    /// the balance is not finite.
+    bool update(const Account& acct);
+
+    /// Removes an account. Returns false if the key is unknown.
+    bool erase(const key_type& key);
+
+    /// Retrieves an account by key. Returns false if the key is unknown.
+    bool retrieve(const key_type& key, Account& acct) const;
+
+    [[nodiscard]] size_type size() const { return m_accounts.size(); }
+    [[nodiscard]] bool empty() const { return m_accounts.empty(); }
+
+    /// All accounts of a bank.
+    [[nodiscard]] std::vector<Account> by_bank(int bank) const;
+
+    /// All accounts of a branch of a bank.
+    [[nodiscard]] std::vector<Account> by_branch(int bank, int branch) const;
+
+    /// All accounts whose balance lies in `[low, high]`, in increasing order of balance.
+    [[nodiscard]] std::vector<Account> by_balance(float low, float high) const;
+
+private:
+    /// Adds an account (already in the primary table) to the secondary indexes.
+    void index(const Account& acct);
+    /// Removes an account from the secondary indexes.
+    void unindex(const Account& acct);
+    /// Collects the accounts with the given keys.
+    [[nodiscard]] std::vector<Account> collect(const std::set<key_type>& keys) const;
+    /// Whether a balance may be stored: a NaN would break the order of the balance index.
+    static bool valid_balance(float balance) { return std::isfinite(balance); }
+    /// Key of the (bank, branch) index.
+    static long long branch_key(int bank, int branch);
+
+    ac::HashTbl<key_type, Account, KeyHash, KeyEqual> m_accounts;  //!< Primary table.
+    ac::HashTbl<int, std::set<key_type>> m_by_bank;                //!< Keys of each bank.
+    ac::HashTbl<long long, std::set<key_type>> m_by_branch;        //!< Keys of each (bank, branch).
+    std::multimap<float, key_type> m_by_balance;                   //!< Keys ordered by balance.
+};
+
+#endif
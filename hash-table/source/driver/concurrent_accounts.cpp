@@ -0,0 +1,218 @@
+/*!
+ * @file: concurrent_accounts.cpp
+ */
+#include "concurrent_accounts.h"
+
+#include <stdexcept>
+
+/// Inserts an account, replacing the account with the same key.
+bool ConcurrentAccounts::insert(const Account& acct)
+{
+    auto& stripe = m_stripes[stripe_of(acct.getKey())];
+    std::lock_guard<std::mutex> guard{ stripe.m_lock };
+    return stripe.m_accounts.insert(acct.getKey(), acct);
+}
+
+/// Removes an account.
+bool ConcurrentAccounts::erase(const key_type& key)
+{
+    // a hot account must exist, since its credits skip the lock of its stripe
+    size_type s = stripe_of(key);
+    if (hot_of(key, s) != nullptr)
+        return false;
+
+    auto& stripe = m_stripes[s];
+    std::lock_guard<std::mutex> guard{ stripe.m_lock };
+    return stripe.m_accounts.erase(key);
+}
+
+/// Retrieves an account by key.
+bool ConcurrentAccounts::retrieve(const key_type& key, Account& acct) const
+{
+    size_type s = stripe_of(key);
+    const auto& stripe = m_stripes[s];
+    std::lock_guard<std::mutex> guard{ stripe.m_lock };
+    if (not stripe.m_accounts.retrieve(key, acct))
+        return false;
+    if (auto* pending = hot_of(key, s))
+        acct.m_balance += static_cast<float>(pending->load());
+    return true;
+}
+
+/// Number of accounts.
+ConcurrentAccounts::size_type ConcurrentAccounts::size() const
+{
+    size_type total = 0;
+    for (const auto& stripe : m_stripes) {
+        std::lock_guard<std::mutex> guard{ stripe.m_lock };
+        total += stripe.m_accounts.size();
+    }
+    return total;
+}
+
+/// Moves an amount between two accounts.
+bool ConcurrentAccounts::transfer(const key_type& from, const key_type& to, float amount)
+{
+    if (not valid_amount(amount))
+        return false;
+
+    // a transfer to the same account changes nothing, but still needs the funds
+    if (KeyEqual{}(from, to)) {
+        Account acct;
+        return retrieve(from, acct) and acct.m_balance >= amount;
+    }
+
+    size_type a = stripe_of(from), b = stripe_of(to);
+
+    // a credit to a hot account needs only the stripe of the source
+    if (auto* pending = hot_of(to, b)) {
+        auto& stripe = m_stripes[a];
+        std::lock_guard<std::mutex> guard{ stripe.m_lock };
+        try {
+            auto& source = stripe.m_accounts.at(from);
+            if (auto* own = hot_of(from, a))
+                fold(source, own);
+            if (source.m_balance < amount)
+                return false;
+            source.m_balance -= amount;
+            // added with the source locked, so total_balance() sees both halves or neither
+            pending->add(amount);
+            return true;
+        } catch (const std::out_of_range&) {
+            return false;
+        }
+    }
+
+    // the two stripes are locked in increasing order, like in transact()
+    std::unique_lock<std::mutex> first{ m_stripes[std::min(a, b)].m_lock };
+    std::unique_lock<std::mutex> second;
+    if (a != b)
+        second = std::unique_lock<std::mutex>{ m_stripes[std::max(a, b)].m_lock };
+
+    // the balances are changed in place, so no account is copied
+    try {
+        auto& source = m_stripes[a].m_accounts.at(from);
+        auto& target = m_stripes[b].m_accounts.at(to);
+        if (auto* own = hot_of(from, a))
+            fold(source, own);
+        if (source.m_balance < amount)
+            return false;
+        source.m_balance -= amount;
+        target.m_balance += amount;
+        return true;
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+}
+
+/// Sum of all balances.
+double ConcurrentAccounts::total_balance() const
+{
+    // every stripe stays locked until the sum is complete (stripes locked in increasing order)
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(N_STRIPES);
+    for (const auto& stripe : m_stripes)
+        locks.emplace_back(stripe.m_lock);
+
+    double total = 0;
+    for (const auto& stripe : m_stripes)
+        stripe.m_accounts.for_each([&](const auto& entry) { total += entry.m_data.m_balance; });
+    m_hot.for_each([&](const auto& entry) { total += entry.m_data->load(); });
+    return total;
+}
+
+/// Adds an amount to an account.
+bool ConcurrentAccounts::credit(const key_type& key, float amount)
+{
+    // a hot account takes credits without any check of its balance, so a debit must not pass for one
+    if (not valid_amount(amount))
+        return false;
+
+    // a hot account exists, and the credit touches only the slot of this thread
+    size_type s = stripe_of(key);
+    if (auto* pending = hot_of(key, s)) {
+        pending->add(amount);
+        return true;
+    }
+
+    auto& stripe = m_stripes[s];
+    std::lock_guard<std::mutex> guard{ stripe.m_lock };
+    try {
+        stripe.m_accounts.at(key).m_balance += amount;
+        return true;
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+}
+
+/// Makes an account hot.
+bool ConcurrentAccounts::make_hot(const key_type& key)
+{
+    Account acct;
+    size_type s = stripe_of(key);
+    if (hot_of(key, s) != nullptr or not retrieve(key, acct))
+        return false;
+
+    m_counters.push_back(std::make_unique<counter_type>());
+    m_hot.insert(key, m_counters.back().get());
+    ++m_stripes[s].m_hot;
+    return true;
+}
+
+/// Makes a hot account cold.
+bool ConcurrentAccounts::make_cold(const key_type& key)
+{
+    size_type s = stripe_of(key);
+    auto* pending = hot_of(key, s);
+    if (pending == nullptr)
+        return false;
+
+    {
+        auto& stripe = m_stripes[s];
+        std::lock_guard<std::mutex> guard{ stripe.m_lock };
+        fold(stripe.m_accounts.at(key), pending);
+    }
+    m_hot.erase(key);
+    --m_stripes[s].m_hot;
+    m_counters.erase(std::find_if(m_counters.begin(), m_counters.end(),
+                                  [&](const auto& c) { return c.get() == pending; }));
+    return true;
+}
+
+/// Folds the pending credits of every hot account.
+void ConcurrentAccounts::fold_hot()
+{
+    m_hot.for_each([&](const auto& entry) {
+        auto& stripe = m_stripes[stripe_of(entry.m_key)];
+        std::lock_guard<std::mutex> guard{ stripe.m_lock };
+        fold(stripe.m_accounts.at(entry.m_key), entry.m_data);
+    });
+}
+
+/// Pending credits of a key.
+ConcurrentAccounts::counter_type* ConcurrentAccounts::hot_of(const key_type& key, size_type stripe) const
+{
+    // most stripes hold no hot account, which spares hashing the key again
+    counter_type* pending = nullptr;
+    if (m_stripes[stripe].m_hot > 0)
+        m_hot.retrieve(key, pending);
+    return pending;
+}
+
+/// Locks the stripes of the given keys, in increasing order.
+std::vector<std::unique_lock<std::mutex>> ConcurrentAccounts::lock_all(const std::vector<key_type>& keys) const
+{
+    // a global order of the locks rules out deadlocks between transactions
+    std::vector<size_type> stripes;
+    stripes.reserve(keys.size());
+    for (const auto& key : keys)
+        stripes.push_back(stripe_of(key));
+    std::sort(stripes.begin(), stripes.end());
+    stripes.erase(std::unique(stripes.begin(), stripes.end()), stripes.end());
+
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(stripes.size());
+    for (auto s : stripes)
+        locks.emplace_back(m_stripes[s].m_lock);
+    return locks;
+}
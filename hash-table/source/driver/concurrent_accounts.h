@@ -0,0 +1,135 @@
+/*!
+ * @brief Account table shared by many threads, with atomic multi-account transactions.
+ * @file concurrent_accounts.h
+ */
+
+#ifndef CONCURRENT_ACCOUNTS_H
+#define CONCURRENT_ACCOUNTS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../include/hash_mix.h"
+#include "../include/hashtbl.h"
+#include "../include/striped_counter.h"
+#include "account.h"
+
+/// Splits the accounts into stripes, each a HashTbl with its own lock. A transaction locks the
+/// stripes of its accounts in increasing stripe order (so no two transactions can deadlock),
+/// changes copies of the accounts and writes them back only if it commits. Transactions on
+/// different stripes run in parallel.
+///
+/// Accounts that receive a large share of the credits (e.g. merchants) may be made hot: credits
+/// to a hot account go to a StripedCounter of pending credits, one slot per thread, and are
+/// folded into its balance when the account is debited, by a transaction, or by fold_hot().
+/// Reads include the pending credits.
+class ConcurrentAccounts {
+public:
+    using key_type = Account::AcctKey;
+    using size_type = std::size_t;
+    static constexpr size_type N_STRIPES = 256;  //!< Number of stripes.
+
+    /// Inserts an account, replacing the account with the same key. Returns true for new accounts.
+    bool insert(const Account& acct);
+
+    /// Removes an account. Returns false if the key is unknown or the account is hot.
+    bool erase(const key_type& key);
+
+    /// Retrieves an account by key. Returns false if the key is unknown.
+    bool retrieve(const key_type& key, Account& acct) const;
+
+    /// Number of accounts (a snapshot, if other threads are changing the table).
+    [[nodiscard]] size_type size() const;
+
+    /// Moves `amount` from one account to another. Returns false (and changes nothing) if the
+    /// amount is not a positive finite number, an account is unknown or the source balance is
+    /// smaller than the amount.
+    bool transfer(const key_type& from, const key_type& to, float amount);
+
+    /// Adds `amount` to the balance of an account. Returns false (and changes nothing) if the
+    /// amount is not a positive finite number or the account is unknown.
+    bool credit(const key_type& key, float amount);
+
+    /// Makes an account hot. Returns false if it is unknown or already hot. Not thread safe: no
+    /// other thread may use the table meanwhile (e.g. call it at startup).
+    bool make_hot(const key_type& key);
+
+    /// Folds the pending credits of an account and makes it cold again. Returns false if it is
+    /// not hot. Not thread safe, like make_hot().
+    bool make_cold(const key_type& key);
+
+    /// Folds the pending credits of every hot account into its balance.
+    void fold_hot();
+
+    /// Runs `fn` on copies of the accounts with the given keys (a `std::vector<Account>&`, in the
+    /// order of the keys) with all of them locked. If `fn` returns true, the copies replace the
+    /// accounts; otherwise nothing changes. Returns false if a key is unknown or `fn` aborts.
+    /// The keys must be distinct, and `fn` must not change the keys of the accounts.
+    template <typename Function>
+    bool transact(const std::vector<key_type>& keys, Function fn);
+
+    /// Sum of all balances, with every stripe locked (a consistent snapshot).
+    [[nodiscard]] double total_balance() const;
+
+private:
+    /// A stripe: a table and the lock that guards it, on its own cache lines.
+    struct alignas(64) Stripe {
+        mutable std::mutex m_lock;
+        ac::HashTbl<key_type, Account, KeyHash, KeyEqual> m_accounts;
+        size_type m_hot = 0;  //!< Number of hot accounts in the stripe.
+    };
+
+    using counter_type = ac::StripedCounter<double>;
+
+    /// Pending credits of a key in a given stripe, or nullptr if the account is not hot.
+    counter_type* hot_of(const key_type& key, size_type stripe) const;
+
+    /// Moves the pending credits of a hot account into its balance (with its stripe locked).
+    static void fold(Account& acct, counter_type* pending) { acct.m_balance += static_cast<float>(pending->drain()); }
+
+    /// Whether an amount may be moved: positive and finite (a negative amount would move money the
+    /// other way, skipping the funds check, and a NaN would pass it).
+    static bool valid_amount(float amount) { return std::isfinite(amount) and amount > 0; }
+
+    /// Stripe of a key.
+    static size_type stripe_of(const key_type& key) { return ac::mix64(KeyHash{}(key)) % N_STRIPES; }
+
+    /// Locks the stripes of the given keys, in increasing order.
+    std::vector<std::unique_lock<std::mutex>> lock_all(const std::vector<key_type>& keys) const;
+
+    std::array<Stripe, N_STRIPES> m_stripes;  //!< The stripes.
+    ac::HashTbl<key_type, counter_type*, KeyHash, KeyEqual> m_hot;  //!< Pending credits of the hot accounts (read-only while shared).
+    std::vector<std::unique_ptr<counter_type>> m_counters;  //!< Owns the counters of m_hot.
+};
+
+/// Runs a transaction over several accounts.
+template <typename Function>
+bool ConcurrentAccounts::transact(const std::vector<key_type>& keys, Function fn)
+{
+    auto locks = lock_all(keys);
+
+    // works on copies, so an aborted transaction leaves no trace
+    std::vector<Account> accounts(keys.size());
+    for (size_type i = 0; i < keys.size(); ++i) {
+        size_type s = stripe_of(keys[i]);
+        auto& stored = m_stripes[s].m_accounts;
+        // credits arriving from now on stay pending, so writing the copy back loses none
+        if (auto* pending = hot_of(keys[i], s))
+            fold(stored.at(keys[i]), pending);
+        if (not stored.retrieve(keys[i], accounts[i]))
+            return false;
+    }
+
+    if (not fn(accounts))
+        return false;
+
+    for (size_type i = 0; i < keys.size(); ++i)
+        m_stripes[stripe_of(keys[i])].m_accounts.at(keys[i]) = accounts[i];
+    return true;
+}
+
+#endif
@@ -0,0 +1,381 @@
+/*!
+ * @brief Load driver: replays a synthetic transaction workload against a HashTbl of accounts.
+ *
+ * Usage: load_hash [--accounts=N] [--ops=N] [--mix=LOOKUP:INSERT:UPDATE:ERASE]
+ *                  [--dist=uniform|zipf|hot] [--theta=T] [--hot-keys=F] [--hot-prob=P]
+ *                  [--threads=N] [--seed=S] [--cache=SLOTS]
+ *
+ * Built with AC_HASHTBL_INSTRUMENT, it also reports the latencies measured inside HashTbl
+ * (without the time spent waiting for the table lock).
+ *
+ * @file load_driver.cpp
+ */
+#include <algorithm>
+#include <cctype>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/hash_mix.h"
+#include "../include/hashtbl.h"
+#include "../include/latency_histogram.h"
+#include "account.h"
+
+namespace {
+
+/// The operations of the workload.
+enum class Op : std::uint8_t { LOOKUP = 0, INSERT, UPDATE, ERASE };
+constexpr std::array<const char*, 4> OP_NAMES{ "lookup", "insert", "update", "erase" };
+
+/// The running options.
+struct Options {
+    std::size_t accounts{ 1000000 };                 //!< Number of distinct accounts (key space).
+    std::size_t ops{ 2000000 };                      //!< Total number of operations (all threads).
+    std::array<double, 4> mix{ 90, 4, 4, 2 };        //!< Share of each operation, in Op order.
+    std::string dist{ "zipf" };                      //!< Key distribution: uniform, zipf or hot.
+    double theta{ 0.99 };                            //!< Skew of the Zipfian distribution, in (0, 1).
+    double hot_keys{ 0.01 };                         //!< Fraction of keys in the hot set.
+    double hot_prob{ 0.9 };                          //!< Probability of accessing the hot set.
+    std::size_t threads{ 1 };                        //!< Number of client threads.
+    std::uint64_t seed{ 42 };                        //!< Random seed.
+    std::size_t cache{ 0 };                          //!< Slots of the HashTbl hot-key cache (0: none).
+};
+
+/// Prints the usage message.
+void usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--accounts=N] [--ops=N] [--mix=LOOKUP:INSERT:UPDATE:ERASE]\n"
+              << "       [--dist=uniform|zipf|hot] [--theta=T] [--hot-keys=F] [--hot-prob=P]\n"
+              << "       [--threads=N] [--seed=S] [--cache=SLOTS]\n";
+}
+
+/// Reads a whole string as an integer in [low, high]. Returns false if it is not one.
+bool to_integer(const std::string& text, std::uint64_t low, std::uint64_t high, std::uint64_t& number)
+{
+    std::size_t used = 0;
+    // stoull would accept (and negate) a leading minus sign
+    if (text.empty() or not std::isdigit(static_cast<unsigned char>(text[0])))
+        return false;
+    try {
+        number = std::stoull(text, &used);
+    } catch (const std::logic_error&) {  // invalid_argument or out_of_range
+        return false;
+    }
+    return used == text.size() and number >= low and number <= high;
+}
+
+/// Reads a whole string as a finite real number. Returns false if it is not one.
+bool to_real(const std::string& text, double& number)
+{
+    std::size_t used = 0;
+    try {
+        number = std::stod(text, &used);
+    } catch (const std::logic_error&) {  // invalid_argument or out_of_range
+        return false;
+    }
+    return not text.empty() and used == text.size() and std::isfinite(number);
+}
+
+/// Parses `--name=value` arguments. Returns false (after printing a message) on errors.
+bool parse(int argc, char* argv[], Options& opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg{ argv[i] };
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 or eq == std::string::npos) {
+            std::cerr << "Invalid argument: " << arg << "\n";
+            usage(argv[0]);
+            return false;
+        }
+        std::string name = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        // the plans store key indices as 32-bit numbers
+        constexpr std::uint64_t MAX_ACCOUNTS = std::numeric_limits<std::uint32_t>::max();
+        constexpr std::uint64_t MAX_THREADS = 4096;
+        constexpr std::uint64_t MAX_CACHE = std::uint64_t{ 1 } << 30;
+        std::uint64_t n = 0;
+        bool ok = true;
+        std::string range;
+        if (name == "accounts") {
+            ok = to_integer(value, 1, MAX_ACCOUNTS, n);
+            opt.accounts = n;
+            range = "an integer in [1, " + std::to_string(MAX_ACCOUNTS) + "]";
+        } else if (name == "ops") {
+            ok = to_integer(value, 1, std::numeric_limits<std::size_t>::max(), n);
+            opt.ops = n;
+            range = "a positive integer";
+        } else if (name == "threads") {
+            ok = to_integer(value, 1, MAX_THREADS, n);
+            opt.threads = n;
+            range = "an integer in [1, " + std::to_string(MAX_THREADS) + "]";
+        } else if (name == "seed") {
+            ok = to_integer(value, 0, std::numeric_limits<std::uint64_t>::max(), n);
+            opt.seed = n;
+            range = "a non-negative integer";
+        } else if (name == "cache") {
+            ok = to_integer(value, 0, MAX_CACHE, n);
+            opt.cache = n;
+            range = "an integer in [0, " + std::to_string(MAX_CACHE) + "]";
+        } else if (name == "dist") {
+            opt.dist = value;
+            ok = value == "uniform" or value == "zipf" or value == "hot";
+            range = "uniform, zipf or hot";
+        } else if (name == "theta") {
+            // the Zipfian generator divides by 1 - theta
+            ok = to_real(value, opt.theta) and opt.theta > 0 and opt.theta < 1;
+            range = "a number in (0, 1)";
+        } else if (name == "hot-keys") {
+            ok = to_real(value, opt.hot_keys) and opt.hot_keys > 0 and opt.hot_keys <= 1;
+            range = "a fraction in (0, 1]";
+        } else if (name == "hot-prob") {
+            ok = to_real(value, opt.hot_prob) and opt.hot_prob >= 0 and opt.hot_prob <= 1;
+            range = "a probability in [0, 1]";
+        } else if (name == "mix") {
+            // four non-negative weights, not all zero, as discrete_distribution requires
+            std::istringstream weights{ value };
+            std::string weight;
+            double sum = 0;
+            std::size_t k = 0;
+            for (; ok and std::getline(weights, weight, ':'); ++k) {
+                ok = k < opt.mix.size() and to_real(weight, opt.mix[k]) and opt.mix[k] >= 0;
+                sum += ok ? opt.mix[k] : 0;
+            }
+            ok = ok and k == opt.mix.size() and value.back() != ':' and sum > 0;
+            range = "four non-negative weights, not all zero, as LOOKUP:INSERT:UPDATE:ERASE";
+        } else {
+            std::cerr << "Unknown option: " << name << "\n";
+            usage(argv[0]);
+            return false;
+        }
+        if (not ok) {
+            std::cerr << "Invalid value for option " << name << ": " << value << " (" << range << ")\n";
+            usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Draws ranks in [0, n) with a Zipfian distribution (Gray et al., "Quickly generating
+/// billion-record synthetic databases"), as done by YCSB.
+class ZipfGenerator {
+public:
+    ZipfGenerator(std::size_t n, double theta) : m_n{ n }, m_theta{ theta }
+    {
+        for (std::size_t i = 1; i <= n; ++i)
+            m_zetan += 1.0 / std::pow(static_cast<double>(i), theta);
+        double zeta2 = 1.0 + 1.0 / std::pow(2.0, theta);
+        m_alpha = 1.0 / (1.0 - theta);
+        m_eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / m_zetan);
+    }
+
+    template <typename Rng>
+    std::size_t operator()(Rng& rng)
+    {
+        double u = std::uniform_real_distribution<double>{ 0.0, 1.0 }(rng);
+        double uz = u * m_zetan;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + std::pow(0.5, m_theta))
+            return 1;
+        auto rank = static_cast<std::size_t>(m_n * std::pow(m_eta * u - m_eta + 1.0, m_alpha));
+        return std::min(rank, m_n - 1);
+    }
+
+private:
+    std::size_t m_n;
+    double m_theta;
+    double m_zetan{ 0 };
+    double m_alpha{ 0 };
+    double m_eta{ 0 };
+};
+
+/// Builds the synthetic account with the given index.
+Account make_account(std::size_t i)
+{
+    return Account("Client " + std::to_string(i), static_cast<int>(1 + i % 200),
+                   static_cast<int>(1 + (i / 200) % 5000), static_cast<int>(i),
+                   static_cast<float>(i % 100000));
+}
+
+/// Prints the header of a latency table.
+void print_header(const std::string& title)
+{
+    std::cout << title << "\n"
+              << std::setw(8) << "op" << std::setw(12) << "count" << std::setw(10) << "p50" << std::setw(10)
+              << "p99" << std::setw(10) << "p999" << std::setw(12) << "max (ns)\n";
+}
+
+/// Prints one row of a latency table.
+void print_row(const std::string& name, const ac::LatencyHistogram& h)
+{
+    std::cout << std::setw(8) << name << std::setw(12) << h.count() << std::setw(10) << h.percentile(50)
+              << std::setw(10) << h.percentile(99) << std::setw(10) << h.percentile(99.9) << std::setw(11)
+              << h.max() << "\n";
+}
+
+} // namespace
+
+//=== DRIVER CODE
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    if (not parse(argc, argv, opt))
+        return EXIT_FAILURE;
+
+    using Table = ac::HashTbl<Account::AcctKey, Account, KeyHash, KeyEqual>;
+    using clock = std::chrono::steady_clock;
+
+    // Synthetic data set: every key of the key space, and half of the accounts preloaded.
+    std::cout << ">>> Generating " << opt.accounts << " accounts...\n";
+    std::vector<Account> accounts;
+    std::vector<Account::AcctKey> keys;
+    accounts.reserve(opt.accounts);
+    keys.reserve(opt.accounts);
+    for (std::size_t i = 0; i < opt.accounts; ++i) {
+        accounts.push_back(make_account(i));
+        keys.push_back(accounts.back().getKey());
+    }
+
+    Table table;
+    table.hot_cache(opt.cache);
+    for (std::size_t i = 0; i < opt.accounts; i += 2)
+        table.insert(keys[i], accounts[i]);
+
+    // The operations of each thread are drawn before the clock starts.
+    std::cout << ">>> Generating " << opt.ops << " operations (" << opt.dist << ")...\n";
+    std::vector<std::vector<std::pair<Op, std::uint32_t>>> plans(opt.threads);
+    {
+        ZipfGenerator zipf{ opt.accounts, opt.theta };
+        std::discrete_distribution<int> pick_op(opt.mix.begin(), opt.mix.end());
+        std::uniform_int_distribution<std::size_t> uniform(0, opt.accounts - 1);
+        auto n_hot = std::max<std::size_t>(1, static_cast<std::size_t>(opt.hot_keys * opt.accounts));
+        std::uniform_int_distribution<std::size_t> hot(0, n_hot - 1);
+        std::bernoulli_distribution in_hot(opt.hot_prob);
+
+        for (std::size_t t = 0; t < opt.threads; ++t) {
+            std::mt19937_64 rng{ opt.seed + t };
+            std::size_t n = opt.ops / opt.threads + (t < opt.ops % opt.threads ? 1 : 0);
+            plans[t].reserve(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                std::size_t idx;
+                if (opt.dist == "uniform")
+                    idx = uniform(rng);
+                else if (opt.dist == "zipf")
+                    // popular ranks are scattered over the key space
+                    idx = ac::mix64(zipf(rng)) % opt.accounts;
+                else
+                    idx = in_hot(rng) ? ac::mix64(hot(rng)) % opt.accounts : uniform(rng);
+                plans[t].emplace_back(static_cast<Op>(pick_op(rng)), static_cast<std::uint32_t>(idx));
+            }
+        }
+    }
+
+    // HashTbl is not thread safe: the client threads share it behind one lock.
+    std::mutex table_lock;
+    std::vector<std::array<ac::LatencyHistogram, 4>> latencies(opt.threads);
+    std::vector<std::array<std::size_t, 4>> misses(opt.threads);
+
+    auto client = [&](std::size_t t) {
+        auto& lat = latencies[t];
+        auto& miss = misses[t];
+        miss.fill(0);
+        Account acct;
+        for (auto [op, idx] : plans[t]) {
+            auto start = clock::now();
+            {
+                std::lock_guard<std::mutex> guard{ table_lock };
+                switch (op) {
+                case Op::LOOKUP:
+                    if (not table.retrieve(keys[idx], acct))
+                        ++miss[static_cast<int>(op)];
+                    break;
+                case Op::INSERT:
+                    // inserting a key already in the table counts as a miss
+                    if (not table.insert(keys[idx], accounts[idx]))
+                        ++miss[static_cast<int>(op)];
+                    break;
+                case Op::UPDATE:
+                    // only accounts in the table are changed: operator[] would insert an empty one
+                    try {
+                        table.at(keys[idx]).m_balance += 1.f;
+                    } catch (const std::out_of_range&) {
+                        ++miss[static_cast<int>(op)];
+                    }
+                    break;
+                case Op::ERASE:
+                    if (not table.erase(keys[idx]))
+                        ++miss[static_cast<int>(op)];
+                    break;
+                }
+            }
+            auto end = clock::now();
+            lat[static_cast<int>(op)].record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    };
+
+#if defined(AC_HASHTBL_INSTRUMENT)
+    // only the calls of the workload are reported
+    ac::HashTblStats::reset();
+#endif
+    std::cout << ">>> Running on " << opt.threads << " thread(s)...\n";
+    auto start = clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < opt.threads; ++t)
+        workers.emplace_back(client, t);
+    client(0);
+    for (auto& w : workers)
+        w.join();
+    auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+    // Report.
+    std::cout << "\n>>> Throughput: " << std::fixed << std::setprecision(0) << opt.ops / elapsed
+              << " ops/s (" << std::setprecision(3) << elapsed << " s, final size " << table.size()
+              << ")\n\n";
+    print_header(">>> Latency seen by the clients (lock wait included):");
+    ac::LatencyHistogram all;
+    for (std::size_t o = 0; o < OP_NAMES.size(); ++o) {
+        ac::LatencyHistogram merged;
+        for (auto& lat : latencies)
+            merged.merge(lat[o]);
+        all.merge(merged);
+        print_row(OP_NAMES[o], merged);
+    }
+    print_row("all", all);
+
+    // operations whose key was absent (or, for inserts, already present)
+    std::cout << "\n>>> Misses:";
+    for (std::size_t o = 0; o < OP_NAMES.size(); ++o) {
+        std::size_t total = 0;
+        for (auto& miss : misses)
+            total += miss[o];
+        std::cout << " " << OP_NAMES[o] << " " << total;
+    }
+    std::cout << "\n";
+
+#if defined(AC_HASHTBL_INSTRUMENT)
+    // the calls made by the clients map to these HashTbl methods
+    constexpr std::array<const char*, 4> METHODS{ "insert", "retrieve", "erase", "at" };
+    auto stats = ac::HashTblStats::snapshot();
+    print_header("\n>>> Latency inside HashTbl (workload calls only):");
+    for (std::size_t o = 0; o < METHODS.size(); ++o)
+        print_row(METHODS[o], stats[o]);
+#endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+/*!
+ * @file: packed_key.cpp
+ */
+#include "packed_key.h"
+
+#include <stdexcept>
+
+#include "../include/hash_mix.h"
+
+/// Returns the id of a name, adding the name to the pool if needed.
+NamePool::id_type NamePool::intern(const std::string& name)
+{
+    id_type id;
+    if (m_ids.retrieve(name, id))
+        return id;
+
+    id = static_cast<id_type>(m_names.size());
+    m_names.push_back(name);
+    m_ids.insert(name, id);
+    return id;
+}
+
+/// Looks up the id of a name without adding it.
+bool NamePool::find(const std::string& name, id_type& id) const
+{
+    return m_ids.retrieve(name, id);
+}
+
+/// Returns the name with the given id.
+const std::string& NamePool::name(id_type id) const
+{
+    return m_names.at(id);
+}
+
+/// Packs the codes of an account.
+PackedKey PackedKey::pack(NamePool::id_type name_id, int bank, int branch, int number)
+{
+    if (bank < 0 or bank > 0xffff or branch < 0 or branch > 0xffff or number < 0)
+        throw std::out_of_range("PackedKey: account code out of range");
+
+    PackedKey key;
+    key.m_name_id = name_id;
+    key.m_codes = (static_cast<std::uint64_t>(bank) << 48) | (static_cast<std::uint64_t>(branch) << 32)
+                  | static_cast<std::uint64_t>(number);
+    return key;
+}
+
+/// Compare two packed keys.
+bool operator==(const PackedKey& a, const PackedKey& b)
+{
+    return a.m_name_id == b.m_name_id and a.m_codes == b.m_codes;
+}
+
+std::size_t PackedKeyHash::operator()(const PackedKey& k_) const
+{
+    return ac::mix64(k_.m_codes, k_.m_name_id);
+}
+
+/// Builds the packed key of an account, interning its client name.
+PackedKey pack_key(const Account& acct, NamePool& pool)
+{
+    return PackedKey::pack(pool.intern(acct.m_name), acct.m_bank_code, acct.m_branch_code, acct.m_number);
+}
+
+/// Builds the packed key of an account key, without changing the pool.
+bool find_key(const Account::AcctKey& key, const NamePool& pool, PackedKey& packed)
+{
+    const auto& [name, bkid, brid, accn] = key;
+    NamePool::id_type id;
+    if (not pool.find(name, id))
+        return false;
+    packed = PackedKey::pack(id, bkid, brid, accn);
+    return true;
+}
+
+/// Rebuilds an account from its packed key and balance.
+Account unpack_account(const PackedKey& key, float balance, const NamePool& pool)
+{
+    return Account(pool.name(key.m_name_id), key.bank_code(), key.branch_code(), key.number(), balance);
+}
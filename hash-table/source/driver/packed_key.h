@@ -0,0 +1,74 @@
+/*!
+ * @brief Compact account keys: interned client names and packed account codes.
+ * @file packed_key.h
+ */
+
+#ifndef PACKED_KEY_H
+#define PACKED_KEY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../include/hashtbl.h"
+#include "account.h"
+
+/// Interns client names, mapping each distinct name to a 32-bit id.
+class NamePool {
+public:
+    using id_type = std::uint32_t;
+
+    /// Returns the id of a name, adding the name to the pool if needed.
+    id_type intern(const std::string& name);
+
+    /// Looks up the id of a name without adding it. Returns false if the name is unknown.
+    bool find(const std::string& name, id_type& id) const;
+
+    /// Returns the name with the given id (throws std::out_of_range for unknown ids).
+    [[nodiscard]] const std::string& name(id_type id) const;
+
+    /// Number of distinct names in the pool.
+    [[nodiscard]] std::size_t size() const { return m_names.size(); }
+
+private:
+    std::vector<std::string> m_names;           //!< Names, indexed by id.
+    ac::HashTbl<std::string, id_type> m_ids;    //!< Id of each name.
+};
+
+/// Account key made only of integers: a name id plus bank, branch and number packed in 64 bits.
+struct PackedKey {
+    std::uint32_t m_name_id{ 0 };  //!< Id of the client name in a NamePool.
+    std::uint64_t m_codes{ 0 };    //!< bank (16 bits) | branch (16 bits) | number (32 bits).
+
+    /// Packs the codes of an account (throws std::out_of_range if a code does not fit its field).
+    static PackedKey pack(NamePool::id_type name_id, int bank, int branch, int number);
+
+    [[nodiscard]] int bank_code() const { return static_cast<int>(m_codes >> 48); }
+    [[nodiscard]] int branch_code() const { return static_cast<int>((m_codes >> 32) & 0xffff); }
+    [[nodiscard]] int number() const { return static_cast<int>(m_codes & 0xffffffff); }
+};
+
+/// Compare two packed keys.
+bool operator==(const PackedKey& a, const PackedKey& b);
+
+/// Functor that generates a hash number for a packed key.
+struct PackedKeyHash {
+    std::size_t operator()(const PackedKey&) const;
+};
+
+/// Functor that test two packed keys for equality.
+struct PackedKeyEqual {
+    bool operator()(const PackedKey& k1_, const PackedKey& k2_) const { return k1_ == k2_; }
+};
+
+/// Builds the packed key of an account, interning its client name.
+PackedKey pack_key(const Account& acct, NamePool& pool);
+
+/// Builds the packed key of an account key, without changing the pool.
+/// Returns false if the client name was never interned (so no table may hold the key).
+bool find_key(const Account::AcctKey& key, const NamePool& pool, PackedKey& packed);
+
+/// Rebuilds an account from its packed key and balance.
+Account unpack_account(const PackedKey& key, float balance, const NamePool& pool);
+
+#endif
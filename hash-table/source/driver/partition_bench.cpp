@@ -0,0 +1,106 @@
+/*!
+ * @brief Migration benchmark: how many accounts move when shards join or leave a PartitionedTbl.
+ *
+ * Usage: partition_hash [accounts] [shards] [vnodes]
+ *
+ * @file partition_bench.cpp
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/hash_mix.h"
+#include "../include/partitioned_tbl.h"
+#include "account.h"
+
+namespace {
+using Table = ac::PartitionedTbl<Account::AcctKey, Account, KeyHash, KeyEqual>;
+using clock_type = std::chrono::steady_clock;
+
+/// Prints the number of keys of each shard.
+void print_shares(const Table& table)
+{
+    std::cout << "    keys per shard:";
+    for (auto id : table.nodes())
+        std::cout << " [" << id << "] " << table.node_size(id);
+    std::cout << "\n";
+}
+
+/// Fraction of the keys that `hash % n` placement would move when going from n_from to n_to shards.
+double modulo_moves(const std::vector<Account::AcctKey>& keys, std::size_t n_from, std::size_t n_to)
+{
+    KeyHash hash;
+    std::size_t moved = 0;
+    for (const auto& key : keys) {
+        auto h = ac::mix64(hash(key));
+        if (h % n_from != h % n_to)
+            ++moved;
+    }
+    return static_cast<double>(moved) / keys.size();
+}
+
+/// Runs a topology change and reports the keys it moved.
+template <typename Change>
+void measure(const std::string& what, Table& table, Change change, double modulo)
+{
+    auto n = table.size();
+    auto start = clock_type::now();
+    auto moved = change();
+    auto ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+
+    std::cout << ">>> " << what << ": moved " << moved << " of " << n << " keys (" << std::fixed
+              << std::setprecision(1) << 100.0 * moved / n << "%, modulo placement would move "
+              << 100.0 * modulo << "%) in " << std::setprecision(2) << ms << " ms\n";
+    print_shares(table);
+}
+}  // namespace
+
+//=== DRIVER CODE
+
+int main(int argc, char* argv[])
+{
+    std::size_t n_accounts = argc > 1 ? std::stoul(argv[1]) : 200000;
+    std::size_t n_shards = argc > 2 ? std::stoul(argv[2]) : 4;
+    std::size_t vnodes = argc > 3 ? std::stoul(argv[3]) : 128;
+    if (n_accounts == 0 or n_shards == 0) {
+        std::cerr << "Usage: " << argv[0] << " [accounts] [shards] [vnodes]\n";
+        return EXIT_FAILURE;
+    }
+
+    Table table{ vnodes };
+    for (std::size_t s = 0; s < n_shards; ++s)
+        table.add_node(static_cast<Table::node_type>(s));
+
+    std::vector<Account::AcctKey> keys;
+    keys.reserve(n_accounts);
+    for (std::size_t i = 0; i < n_accounts; ++i) {
+        Account acct("Client " + std::to_string(i), static_cast<int>(1 + i % 200),
+                     static_cast<int>(1 + i % 5000), static_cast<int>(i), static_cast<float>(i % 1000));
+        keys.push_back(acct.getKey());
+        table.insert(keys.back(), acct);
+    }
+    std::cout << ">>> " << n_accounts << " accounts on " << n_shards << " shards, " << vnodes
+              << " virtual nodes each\n";
+    print_shares(table);
+
+    auto added = static_cast<Table::node_type>(n_shards);
+    measure("Adding shard " + std::to_string(added), table, [&] { return table.add_node(added); },
+            modulo_moves(keys, n_shards, n_shards + 1));
+    measure("Removing shard 0", table, [&] { return table.remove_node(0); },
+            modulo_moves(keys, n_shards + 1, n_shards));
+
+    // every account is still reachable after the migrations
+    Account acct;
+    for (const auto& key : keys) {
+        if (not table.retrieve(key, acct)) {
+            std::cerr << "Lost an account during the migration!\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::cout << ">>> All " << keys.size() << " accounts found after the migrations.\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,246 @@
+/*!
+ * @brief Contention benchmark: concurrent transfers behind one global lock vs. striped transactions,
+ * with and without striped counters for the hot accounts.
+ *
+ * Usage: transfer_hash [accounts] [threads] [transfers per thread] [hot ratio] [hot accounts]
+ *
+ * A `hot ratio` share of the transfers are payments from any account to one of the `hot accounts`
+ * (e.g. merchants); the others pick both accounts uniformly.
+ *
+ * @file transfer_bench.cpp
+ */
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/hashtbl.h"
+#include "account.h"
+#include "concurrent_accounts.h"
+
+namespace {
+/// The running options.
+struct Options {
+    std::size_t accounts{ 100000 };
+    std::size_t threads{ 4 };
+    std::size_t transfers{ 200000 };
+    double hot_ratio{ 0.1 };
+    std::size_t hot_accounts{ 16 };
+};
+
+/// Prints the usage message.
+void usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [accounts] [threads] [transfers per thread] [hot ratio] [hot accounts]\n";
+}
+
+/// Reads a whole string as an integer in [low, high]. Returns false if it is not one.
+bool to_integer(const std::string& text, std::uint64_t low, std::uint64_t high, std::uint64_t& number)
+{
+    std::size_t used = 0;
+    // stoull would accept (and negate) a leading minus sign
+    if (text.empty() or not std::isdigit(static_cast<unsigned char>(text[0])))
+        return false;
+    try {
+        number = std::stoull(text, &used);
+    } catch (const std::logic_error&) {  // invalid_argument or out_of_range
+        return false;
+    }
+    return used == text.size() and number >= low and number <= high;
+}
+
+/// Reads a whole string as a finite real number. Returns false if it is not one.
+bool to_real(const std::string& text, double& number)
+{
+    std::size_t used = 0;
+    try {
+        number = std::stod(text, &used);
+    } catch (const std::logic_error&) {  // invalid_argument or out_of_range
+        return false;
+    }
+    return not text.empty() and used == text.size() and std::isfinite(number);
+}
+
+/// Parses the positional arguments. Returns false (after printing a message) on errors.
+bool parse(int argc, char* argv[], Options& opt)
+{
+    if (argc > 6) {
+        std::cerr << "Too many arguments\n";
+        usage(argv[0]);
+        return false;
+    }
+
+    // the plans store account indices as 32-bit numbers
+    constexpr std::uint64_t MAX_ACCOUNTS = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::uint64_t MAX_THREADS = 4096;
+    constexpr std::uint64_t MAX_TRANSFERS = std::numeric_limits<std::size_t>::max();
+    std::uint64_t n = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string value{ argv[i] };
+        bool ok = true;
+        std::string name, range;
+        if (i == 1) {
+            ok = to_integer(value, 2, MAX_ACCOUNTS, n);
+            opt.accounts = n;
+            name = "accounts";
+            range = "an integer in [2, " + std::to_string(MAX_ACCOUNTS) + "]";
+        } else if (i == 2) {
+            ok = to_integer(value, 1, MAX_THREADS, n);
+            opt.threads = n;
+            name = "threads";
+            range = "an integer in [1, " + std::to_string(MAX_THREADS) + "]";
+        } else if (i == 3) {
+            ok = to_integer(value, 0, MAX_TRANSFERS, n);
+            opt.transfers = n;
+            name = "transfers per thread";
+            range = "a non-negative integer";
+        } else if (i == 4) {
+            ok = to_real(value, opt.hot_ratio) and opt.hot_ratio >= 0 and opt.hot_ratio <= 1;
+            name = "hot ratio";
+            range = "a fraction in [0, 1]";
+        } else {
+            ok = to_integer(value, 2, MAX_ACCOUNTS, n);
+            opt.hot_accounts = n;
+            name = "hot accounts";
+            range = "an integer in [2, " + std::to_string(MAX_ACCOUNTS) + "]";
+        }
+        if (not ok) {
+            std::cerr << "Invalid value for " << name << ": " << value << " (" << range << ")\n";
+            usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (opt.hot_accounts > opt.accounts) {
+        std::cerr << "There cannot be more hot accounts (" << opt.hot_accounts << ") than accounts ("
+                  << opt.accounts << ")\n";
+        usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+/// One planned transfer.
+struct Move {
+    std::uint32_t from;
+    std::uint32_t to;
+};
+
+/// Accounts shared by all threads behind a single lock (the baseline).
+class GlobalLockAccounts {
+public:
+    void insert(const Account& acct) { m_accounts.insert(acct.getKey(), acct); }
+
+    bool transfer(const Account::AcctKey& from, const Account::AcctKey& to, float amount)
+    {
+        std::lock_guard<std::mutex> guard{ m_lock };
+        try {
+            auto& source = m_accounts.at(from);
+            auto& target = m_accounts.at(to);
+            if (source.m_balance < amount)
+                return false;
+            source.m_balance -= amount;
+            target.m_balance += amount;
+            return true;
+        } catch (const std::out_of_range&) {
+            return false;
+        }
+    }
+
+    double total_balance() const
+    {
+        double total = 0;
+        m_accounts.for_each([&](const auto& entry) { total += entry.m_data.m_balance; });
+        return total;
+    }
+
+private:
+    std::mutex m_lock;
+    ac::HashTbl<Account::AcctKey, Account, KeyHash, KeyEqual> m_accounts;
+};
+
+/// Runs the planned transfers on `n` threads and prints the throughput.
+template <typename Table>
+void run(const std::string& name, Table& table, const std::vector<Account::AcctKey>& keys,
+         const std::vector<std::vector<Move>>& plans)
+{
+    double before = table.total_balance();
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (const auto& plan : plans)
+        workers.emplace_back([&] {
+            for (auto m : plan)
+                table.transfer(keys[m.from], keys[m.to], 1.f);
+        });
+    for (auto& w : workers)
+        w.join();
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::size_t total = 0;
+    for (const auto& plan : plans)
+        total += plan.size();
+
+    // no money is created or destroyed
+    bool conserved = std::abs(table.total_balance() - before) < 0.5;
+    std::cout << std::setw(14) << name << ": " << std::fixed << std::setprecision(0) << total / elapsed
+              << " transfers/s" << (conserved ? "" : "  (BALANCE NOT CONSERVED!)") << "\n";
+}
+}  // namespace
+
+//=== DRIVER CODE
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    if (not parse(argc, argv, opt))
+        return EXIT_FAILURE;
+
+    GlobalLockAccounts global;
+    ConcurrentAccounts striped, counted;
+    std::vector<Account::AcctKey> keys;
+    keys.reserve(opt.accounts);
+    for (std::size_t i = 0; i < opt.accounts; ++i) {
+        Account acct("Client " + std::to_string(i), static_cast<int>(1 + i % 200),
+                     static_cast<int>(1 + i % 5000), static_cast<int>(i), 1000.f);
+        keys.push_back(acct.getKey());
+        global.insert(acct);
+        striped.insert(acct);
+        counted.insert(acct);
+    }
+    for (std::size_t i = 0; i < opt.hot_accounts; ++i)
+        counted.make_hot(keys[i]);
+
+    // the transfers are drawn before the clock starts
+    std::vector<std::vector<Move>> plans(opt.threads);
+    for (std::size_t t = 0; t < opt.threads; ++t) {
+        std::mt19937 rng(static_cast<unsigned>(t + 1));
+        std::uniform_int_distribution<std::uint32_t> any(0, static_cast<std::uint32_t>(opt.accounts - 1));
+        std::uniform_int_distribution<std::uint32_t> hot(0, static_cast<std::uint32_t>(opt.hot_accounts - 1));
+        std::bernoulli_distribution is_hot(opt.hot_ratio);
+        plans[t].reserve(opt.transfers);
+        while (plans[t].size() < opt.transfers) {
+            bool h = is_hot(rng);
+            Move m{ any(rng), h ? hot(rng) : any(rng) };
+            if (m.from != m.to)
+                plans[t].push_back(m);
+        }
+    }
+
+    std::cout << ">>> " << opt.accounts << " accounts, " << opt.threads << " threads x " << opt.transfers
+              << " transfers, " << opt.hot_ratio * 100 << "% paid to " << opt.hot_accounts << " hot accounts\n";
+    run("global lock", global, keys, plans);
+    run("striped locks", striped, keys, plans);
+    run("hot counters", counted, keys, plans);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+/*!
+ * @brief This file contains the declaration of the BlockHashTbl class.
+ *
+ * BlockHashTbl is a hash table with separate chaining whose buckets are cache-line sized
+ * blocks of hash tags and entry indices, instead of linked lists of entries.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file block_hashtbl.h
+ */
+
+#ifndef BLOCK_HASHTBL_H
+#define BLOCK_HASHTBL_H
+
+#include <cstdint>    // std::uint8_t, std::uint32_t, std::uint64_t
+#include <functional> // hash, equal_to
+#include <stdexcept>  // out_of_range, length_error
+#include <vector>     // vector
+
+#include "hashtbl.h"
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @class BlockHashTbl
+     * @brief A chained hash table whose chains are 64-byte blocks rather than list nodes.
+     *
+     * @note The entries live in one dense array, in no particular order. Each bucket is a
+     * 64-byte block holding up to BLOCK_SLOTS pairs of a 7-bit hash tag and the index of an
+     * entry. Only when a block fills is an overflow block chained to it, so a lookup reads one
+     * cache line of tags (rarely two), and compares a key only where its tag matches. Erasing
+     * moves the last entry into the hole, so the entry array never has gaps.
+     *
+     * References to entries are invalidated by insert(), operator[] and erase().
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class BlockHashTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>; //!< The type of individual entries in the table.
+            using size_type  = std::size_t; //!< The size type.
+
+            static constexpr size_type BLOCK_SLOTS = 12; //!< Entries referred to by each block.
+
+            /*!
+             * @brief Default constructor.
+             * @param buckets_ The initial number of buckets (rounded up to a power of two).
+             */
+            explicit BlockHashTbl( size_type buckets_ = DEFAULT_BUCKETS );
+
+            /*!
+             * @brief Inserts a new entry or updates the data of an existing one.
+             * @param key_ The key of the entry.
+             * @param new_data_ The data of the entry.
+             * @return bool True if the key was inserted, False if it was updated.
+             */
+            bool insert( const KeyType & key_, const DataType & new_data_ );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Removes an entry from the table.
+             * @param key_ The key of the entry to be removed.
+             * @return bool True if the entry is removed, False if the key is not found.
+             */
+            bool erase( const KeyType & key_ );
+
+            /*!
+             * @brief Accesses the data associated with a given key.
+             *
+             * If the key is not found, an out of range exception is thrown.
+             *
+             * @param key_ The key of the item to be accessed.
+             * @return DataType& Reference to the data associated with the key.
+             */
+            DataType& at( const KeyType & key_ );
+
+            /*!
+             * @brief Accesses the data associated with a given key, inserting default data if the key is not found.
+             * @param key_ The key of the item to be accessed.
+             * @return DataType& Reference to the data associated with the key.
+             */
+            DataType& operator[]( const KeyType & key_ );
+
+            /*!
+             * @brief Removes all the entries of the table.
+             */
+            void clear();
+
+            /*!
+             * @brief Applies a function to every entry stored in the table (a scan of the dense entry array).
+             * @param fn_ A function object callable with `const entry_type &`.
+             */
+            template< typename Function >
+            void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            bool empty() const { return m_entries.empty(); }
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            size_type size() const { return m_entries.size(); }
+
+            /*!
+             * @brief Returns the number of buckets.
+             * @return size_type The number of buckets.
+             */
+            size_type bucket_count() const { return m_mask + 1; }
+
+            /*!
+             * @brief Returns the number of overflow blocks in use.
+             * @return size_type The number of overflow blocks.
+             */
+            size_type overflow_blocks() const { return m_overflow; }
+
+            /*!
+             * @brief Returns the maximum load factor (entries per bucket) of the table.
+             * @return float The maximum load factor.
+             */
+            float max_load_factor() const { return m_max_load_factor; }
+
+            /*!
+             * @brief Sets the maximum load factor (entries per bucket) of the table.
+             *
+             * Above about BLOCK_SLOTS / 2, overflow blocks become common.
+             *
+             * @param mlf The new maximum load factor.
+             */
+            void max_load_factor( float mlf ) { m_max_load_factor = mlf; }
+
+        private:
+            /// A bucket, or an overflow block of a bucket: exactly one cache line.
+            struct alignas( 64 ) Block {
+                std::uint32_t m_index[ BLOCK_SLOTS ]; //!< Index of the entry of each slot.
+                std::uint8_t m_tags[ BLOCK_SLOTS ];   //!< Tag of each slot (0 if empty); the used slots come first.
+                std::uint32_t m_next;                 //!< Index of the overflow block (0 if none).
+            };
+            static_assert( sizeof( Block ) == 64, "a Block must fill one cache line" );
+
+            /// Position of a slot.
+            struct Slot {
+                size_type m_block; //!< Index of the block (NONE if the key is not found).
+                size_type m_slot;  //!< Slot in the block.
+            };
+
+            /// Mixed hash of a key.
+            static std::uint64_t hash_of( const KeyType & key_ ) { KeyHash hash; return mix64( hash( key_ ) ); }
+
+            /// Tag of a hash: 7 of its high bits, with the top bit set so that no tag is 0.
+            static std::uint8_t tag_of( std::uint64_t hash_ ) { return static_cast< std::uint8_t >( ( hash_ >> 57 ) | 0x80 ); }
+
+            /*!
+             * @brief Finds the slot that refers to the entry of a key.
+             * @param key_ The key.
+             * @param hash_ The mixed hash of the key.
+             * @return Slot The slot, with m_block == NONE if the key is not in the table.
+             */
+            Slot find( const KeyType & key_, std::uint64_t hash_ ) const;
+
+            /*!
+             * @brief Stores an entry index in the first free slot of the bucket of a hash, chaining an overflow block if needed.
+             * @param hash_ The mixed hash of the key of the entry.
+             * @param index_ The index of the entry.
+             */
+            void place( std::uint64_t hash_, std::uint32_t index_ );
+
+            /*!
+             * @brief Appends a new entry and refers to it from its bucket, growing the table if needed.
+             * @param key_ The key of the entry.
+             * @param data_ The data of the entry.
+             * @param hash_ The mixed hash of the key.
+             * @return entry_type& The new entry.
+             */
+            entry_type & append( const KeyType & key_, const DataType & data_, std::uint64_t hash_ );
+
+            /*!
+             * @brief Rebuilds the blocks for a new number of buckets (the entries stay where they are).
+             * @param buckets_ The new number of buckets, a power of two.
+             */
+            void rehash( size_type buckets_ );
+
+        private:
+            std::vector< entry_type > m_entries; //!< The entries, without gaps.
+            std::vector< std::uint64_t > m_hashes; //!< Mixed hash of each entry.
+            std::vector< Block > m_blocks; //!< The buckets, followed by the overflow blocks.
+            size_type m_mask{ 0 }; //!< Number of buckets - 1.
+            size_type m_overflow{ 0 }; //!< Number of overflow blocks in use.
+            std::uint32_t m_free{ 0 }; //!< First unused overflow block (0 if none), linked by m_next.
+            float m_max_load_factor{ 6.0 }; //!< The maximum load factor value.
+            static const short DEFAULT_BUCKETS = 2;
+            static constexpr size_type NONE = ~size_type{0}; //!< Block of a key not found.
+    };
+
+} // namespace ac
+#include "block_hashtbl.inl"
+#endif
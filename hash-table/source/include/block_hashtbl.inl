@@ -0,0 +1,252 @@
+#include "block_hashtbl.h"
+
+#include <limits>  // numeric_limits
+#include <utility> // move
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+namespace ac
+{
+    /// Constructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::BlockHashTbl(size_type buckets_)
+    {
+        size_type n{1};
+        while (n < buckets_)
+            n <<= 1;
+        rehash(n);
+    }
+
+    /// Insert.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        std::uint64_t hash = hash_of(key_);
+        Slot s = find(key_, hash);
+        if (s.m_block != NONE)
+        {
+            m_entries[m_blocks[s.m_block].m_index[s.m_slot]].m_data = new_data_;
+            return false;
+        }
+
+        append(key_, new_data_, hash);
+        return true;
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        Slot s = find(key_, hash_of(key_));
+        if (s.m_block == NONE)
+            return false;
+
+        data_item_ = m_entries[m_blocks[s.m_block].m_index[s.m_slot]].m_data;
+        return true;
+    }
+
+    /// Erase.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        std::uint64_t hash = hash_of(key_);
+        Slot s = find(key_, hash);
+        if (s.m_block == NONE)
+            return false;
+
+        std::uint32_t index = m_blocks[s.m_block].m_index[s.m_slot];
+
+        // the last used slot of the chain fills the hole, so the used slots stay first
+        size_type prev = NONE, last = hash & m_mask;
+        while (m_blocks[last].m_next != 0)
+        {
+            prev = last;
+            last = m_blocks[last].m_next;
+        }
+        size_type k = BLOCK_SLOTS;
+        while (m_blocks[last].m_tags[k - 1] == 0)
+            --k;
+        m_blocks[s.m_block].m_index[s.m_slot] = m_blocks[last].m_index[k - 1];
+        m_blocks[s.m_block].m_tags[s.m_slot] = m_blocks[last].m_tags[k - 1];
+        m_blocks[last].m_tags[k - 1] = 0;
+
+        // an emptied overflow block goes back to the free list
+        if (k == 1 && prev != NONE)
+        {
+            m_blocks[prev].m_next = 0;
+            m_blocks[last].m_next = m_free;
+            m_free = static_cast<std::uint32_t>(last);
+            --m_overflow;
+        }
+
+        // the last entry fills the hole of the entry array; its slot is found by its hash
+        std::uint32_t moved = static_cast<std::uint32_t>(m_entries.size() - 1);
+        if (index != moved)
+        {
+            m_entries[index] = std::move(m_entries[moved]);
+            m_hashes[index] = m_hashes[moved];
+            std::uint8_t tag = tag_of(m_hashes[index]);
+            for (size_type b = m_hashes[index] & m_mask;; b = m_blocks[b].m_next)
+            {
+                size_type i{0};
+                while (i < BLOCK_SLOTS && !(m_blocks[b].m_tags[i] == tag && m_blocks[b].m_index[i] == moved))
+                    ++i;
+                if (i < BLOCK_SLOTS)
+                {
+                    m_blocks[b].m_index[i] = index;
+                    break;
+                }
+            }
+        }
+        m_entries.pop_back();
+        m_hashes.pop_back();
+        return true;
+    }
+
+    /// At.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    {
+        Slot s = find(key_, hash_of(key_));
+        if (s.m_block == NONE)
+            throw std::out_of_range("Key not found");
+
+        return m_entries[m_blocks[s.m_block].m_index[s.m_slot]].m_data;
+    }
+
+    /// Operator [].
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    {
+        std::uint64_t hash = hash_of(key_);
+        Slot s = find(key_, hash);
+        if (s.m_block != NONE)
+            return m_entries[m_blocks[s.m_block].m_index[s.m_slot]].m_data;
+
+        return append(key_, DataType(), hash).m_data;
+    }
+
+    /// Clear.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        m_entries.clear();
+        m_hashes.clear();
+        rehash(m_mask + 1);
+    }
+
+    /// For each.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    void BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        for (const auto &entry : m_entries)
+            fn_(entry);
+    }
+
+    /// Find.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Slot
+    BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find(const KeyType &key_, std::uint64_t hash_) const
+    {
+        KeyEqual equal;
+        std::uint8_t tag = tag_of(hash_);
+
+        // one cache line of tags per block; a key is only compared where its tag matches
+        size_type b = hash_ & m_mask;
+        for (;;)
+        {
+            const Block &block = m_blocks[b];
+#if defined(__SSE2__)
+            // all the tags compared at once (the 4 bytes loaded past them are masked out)
+            __m128i tags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block.m_tags));
+            unsigned match = _mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8(static_cast<char>(tag))));
+            match &= (1u << BLOCK_SLOTS) - 1;
+            while (match != 0)
+            {
+                size_type i = static_cast<size_type>(__builtin_ctz(match));
+                if (equal(m_entries[block.m_index[i]].m_key, key_))
+                    return {b, i};
+                match &= match - 1;
+            }
+#else
+            for (size_type i{0}; i < BLOCK_SLOTS && block.m_tags[i] != 0; ++i)
+                if (block.m_tags[i] == tag && equal(m_entries[block.m_index[i]].m_key, key_))
+                    return {b, i};
+#endif
+            // only full blocks have an overflow block
+            if (block.m_next == 0)
+                return {NONE, 0};
+            b = block.m_next;
+        }
+    }
+
+    /// Place.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::place(std::uint64_t hash_, std::uint32_t index_)
+    {
+        size_type b = hash_ & m_mask;
+        while (m_blocks[b].m_next != 0)
+            b = m_blocks[b].m_next;
+
+        size_type i{0};
+        while (i < BLOCK_SLOTS && m_blocks[b].m_tags[i] != 0)
+            ++i;
+
+        if (i == BLOCK_SLOTS)
+        {
+            // the chain is full: an overflow block is taken from the free list, or added
+            size_type extra = m_free;
+            if (extra != 0)
+                m_free = m_blocks[extra].m_next;
+            else
+            {
+                extra = m_blocks.size();
+                if (extra > std::numeric_limits<std::uint32_t>::max())
+                    throw std::length_error("BlockHashTbl: too many overflow blocks");
+                m_blocks.emplace_back();
+            }
+            m_blocks[extra] = Block{};
+            m_blocks[b].m_next = static_cast<std::uint32_t>(extra);
+            ++m_overflow;
+            b = extra;
+            i = 0;
+        }
+
+        m_blocks[b].m_index[i] = index_;
+        m_blocks[b].m_tags[i] = tag_of(hash_);
+    }
+
+    /// Append.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type &
+    BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::append(const KeyType &key_, const DataType &data_, std::uint64_t hash_)
+    {
+        if (m_entries.size() >= std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("BlockHashTbl: too many entries");
+
+        if (m_entries.size() + 1 > (m_mask + 1) * m_max_load_factor)
+            rehash((m_mask + 1) * 2);
+
+        m_entries.emplace_back(key_, data_);
+        m_hashes.push_back(hash_);
+        place(hash_, static_cast<std::uint32_t>(m_entries.size() - 1));
+        return m_entries.back();
+    }
+
+    /// Rehash.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void BlockHashTbl<KeyType, DataType, KeyHash, KeyEqual>::rehash(size_type buckets_)
+    {
+        // only the blocks are rebuilt, from the stored hashes: no key is hashed or moved
+        m_blocks.assign(buckets_, Block{});
+        m_mask = buckets_ - 1;
+        m_overflow = 0;
+        m_free = 0;
+        for (size_type i{0}; i < m_entries.size(); ++i)
+            place(m_hashes[i], static_cast<std::uint32_t>(i));
+    }
+
+} // namespace ac
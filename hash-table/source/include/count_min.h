@@ -0,0 +1,138 @@
+/*!
+ * @brief This file contains the declaration of the CountMinSketch class.
+ *
+ * CountMinSketch estimates how many times each key was added to a stream, in a fixed amount
+ * of memory that does not depend on the number of distinct keys.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file count_min.h
+ */
+
+#ifndef COUNT_MIN_H
+#define COUNT_MIN_H
+
+#include <cstdint>    // std::uint32_t, std::uint64_t
+#include <functional> // hash
+#include <stdexcept>  // invalid_argument
+#include <vector>     // vector
+
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @class CountMinSketch
+     * @brief An approximate counter of key frequencies.
+     *
+     * @note The sketch has `depth` rows of `width` counters. Each key is mapped to one counter
+     * per row, and its estimate is the smallest of those counters, so it never underestimates.
+     * With conservative update, an addition raises only the counters that are below the new
+     * estimate, which greatly reduces the overestimation caused by colliding keys.
+     * With width w = e / epsilon and depth d = ln(1 / delta), the estimate exceeds the true count
+     * by more than `epsilon * total()` with probability at most delta.
+     *
+     * Sketches with the same dimensions can be merged, e.g. one per thread, merged at the end.
+     *
+     * @tparam KeyType The key type.
+     * @tparam KeyHash The hash function.
+     */
+    template< class KeyType, class KeyHash = std::hash< KeyType > >
+    class CountMinSketch {
+        public:
+            // Aliases
+            using counter_type = std::uint32_t; //!< The counter type.
+            using size_type = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Creates an empty sketch.
+             * @param width_ The number of counters in each row (rounded up to a power of two).
+             * @param depth_ The number of rows.
+             */
+            explicit CountMinSketch( size_type width_ = 2048, size_type depth_ = 4 );
+
+            /*!
+             * @brief Creates an empty sketch sized for a given error bound.
+             * @param epsilon_ The error, as a fraction of the total count (e.g. 0.001).
+             * @param delta_ The probability of exceeding the error (e.g. 0.01).
+             * @return CountMinSketch The sketch.
+             */
+            static CountMinSketch with_error( double epsilon_, double delta_ );
+
+            /*!
+             * @brief Adds occurrences of a key.
+             * @param key_ The key.
+             * @param count_ The number of occurrences.
+             */
+            void add( const KeyType & key_, counter_type count_ = 1 );
+
+            /*!
+             * @brief Estimates the number of occurrences of a key (never less than the true number).
+             * @param key_ The key.
+             * @return counter_type The estimate.
+             */
+            counter_type estimate( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Adds the counts of another sketch to this one.
+             *
+             * A std::invalid_argument is thrown if the sketches have different dimensions.
+             *
+             * @param other The sketch to be merged.
+             */
+            void merge( const CountMinSketch & other );
+
+            /*!
+             * @brief Resets all the counters.
+             */
+            void clear();
+
+            /*!
+             * @brief Returns the sum of all the counts added.
+             * @return std::uint64_t The total count.
+             */
+            std::uint64_t total() const { return m_total; }
+
+            /*!
+             * @brief Returns the number of counters in each row.
+             * @return size_type The width.
+             */
+            size_type width() const { return m_mask + 1; }
+
+            /*!
+             * @brief Returns the number of rows.
+             * @return size_type The depth.
+             */
+            size_type depth() const { return m_depth; }
+
+            /*!
+             * @brief Returns the memory used by the counters.
+             * @return size_type The number of bytes.
+             */
+            size_type memory() const { return m_counters.size() * sizeof( counter_type ); }
+
+        private:
+            /*!
+             * @brief Estimates the number of occurrences of a key from its mixed hash value.
+             * @param hash_ The mixed hash value of the key.
+             * @return counter_type The estimate.
+             */
+            counter_type estimate_of( std::uint64_t hash_ ) const;
+
+            /*!
+             * @brief Computes the counter of a key in a row (double hashing over one mixed hash).
+             * @param hash_ The mixed hash value of the key.
+             * @param row_ The row.
+             * @return size_type The index of the counter in m_counters.
+             */
+            size_type cell( std::uint64_t hash_, size_type row_ ) const;
+
+        private:
+            std::vector< counter_type > m_counters; //!< The rows, one after the other.
+            size_type m_mask; //!< width - 1.
+            size_type m_depth; //!< Number of rows.
+            std::uint64_t m_total{ 0 }; //!< Sum of the counts added.
+    };
+
+} // namespace ac
+#include "count_min.inl"
+#endif
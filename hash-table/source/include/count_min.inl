@@ -0,0 +1,107 @@
+#include "count_min.h"
+
+#include <algorithm> // min, max
+#include <cmath>     // ceil, log
+
+namespace ac
+{
+    /// Constructor.
+    template <typename KeyType, typename KeyHash>
+    CountMinSketch<KeyType, KeyHash>::CountMinSketch(size_type width_, size_type depth_)
+    {
+        // a power of two width turns the modulo into a mask
+        size_type width{1};
+        while (width < width_)
+            width <<= 1;
+
+        m_mask = width - 1;
+        m_depth = depth_ == 0 ? 1 : depth_;
+        m_counters.assign(width * m_depth, 0);
+    }
+
+    /// With error.
+    template <typename KeyType, typename KeyHash>
+    CountMinSketch<KeyType, KeyHash> CountMinSketch<KeyType, KeyHash>::with_error(double epsilon_, double delta_)
+    {
+        if (!(epsilon_ > 0 && delta_ > 0 && delta_ < 1))
+            throw std::invalid_argument("CountMinSketch: invalid error bounds");
+
+        auto width = static_cast<size_type>(std::ceil(std::exp(1.0) / epsilon_));
+        auto depth = static_cast<size_type>(std::ceil(std::log(1.0 / delta_)));
+        return CountMinSketch(width, depth);
+    }
+
+    /// Add.
+    template <typename KeyType, typename KeyHash>
+    void CountMinSketch<KeyType, KeyHash>::add(const KeyType &key_, counter_type count_)
+    {
+        KeyHash hash;
+        std::uint64_t h = mix64(hash(key_));
+
+        // conservative update: only the counters below the new estimate are raised
+        counter_type current = estimate_of(h);
+        counter_type target = current + count_ < current ? ~counter_type{0} : current + count_;
+        for (size_type row{0}; row < m_depth; ++row)
+        {
+            auto &counter = m_counters[cell(h, row)];
+            counter = std::max(counter, target);
+        }
+        m_total += count_;
+    }
+
+    /// Estimate.
+    template <typename KeyType, typename KeyHash>
+    typename CountMinSketch<KeyType, KeyHash>::counter_type
+    CountMinSketch<KeyType, KeyHash>::estimate(const KeyType &key_) const
+    {
+        KeyHash hash;
+        return estimate_of(mix64(hash(key_)));
+    }
+
+    /// Merge.
+    template <typename KeyType, typename KeyHash>
+    void CountMinSketch<KeyType, KeyHash>::merge(const CountMinSketch &other)
+    {
+        if (other.m_mask != m_mask || other.m_depth != m_depth)
+            throw std::invalid_argument("CountMinSketch: cannot merge sketches of different dimensions");
+
+        // the sum of two (over)estimates is an (over)estimate of the sum; counters saturate
+        for (size_type i{0}; i < m_counters.size(); ++i)
+        {
+            counter_type sum = m_counters[i] + other.m_counters[i];
+            m_counters[i] = sum < m_counters[i] ? ~counter_type{0} : sum;
+        }
+        m_total += other.m_total;
+    }
+
+    /// Clear.
+    template <typename KeyType, typename KeyHash>
+    void CountMinSketch<KeyType, KeyHash>::clear()
+    {
+        std::fill(m_counters.begin(), m_counters.end(), 0);
+        m_total = 0;
+    }
+
+    /// Estimate from a mixed hash value.
+    template <typename KeyType, typename KeyHash>
+    typename CountMinSketch<KeyType, KeyHash>::counter_type
+    CountMinSketch<KeyType, KeyHash>::estimate_of(std::uint64_t hash_) const
+    {
+        counter_type result = m_counters[cell(hash_, 0)];
+        for (size_type row{1}; row < m_depth; ++row)
+            result = std::min(result, m_counters[cell(hash_, row)]);
+        return result;
+    }
+
+    /// Cell.
+    template <typename KeyType, typename KeyHash>
+    typename CountMinSketch<KeyType, KeyHash>::size_type
+    CountMinSketch<KeyType, KeyHash>::cell(std::uint64_t hash_, size_type row_) const
+    {
+        // the two halves of the hash act as two independent hashes (Kirsch-Mitzenmacher)
+        std::uint64_t h1 = hash_ & 0xffffffff;
+        std::uint64_t h2 = (hash_ >> 32) | 1;
+        return row_ * (m_mask + 1) + ((h1 + row_ * h2) & m_mask);
+    }
+
+} // namespace ac
@@ -0,0 +1,300 @@
+/*!
+ * @brief This file contains the declaration of the DiskHashTbl class.
+ *
+ * DiskHashTbl is an extendible hash table whose entries live in fixed-size pages of a plain
+ * file, so a table may be much larger than the memory of the process.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file disk_hashtbl.h
+ */
+
+#ifndef DISK_HASHTBL_H
+#define DISK_HASHTBL_H
+
+#include <cstdint>       // std::uint32_t, std::uint64_t
+#include <functional>    // hash, equal_to
+#include <list>          // list
+#include <memory>        // unique_ptr
+#include <stdexcept>     // length_error, runtime_error
+#include <string>        // string
+#include <type_traits>   // is_trivially_copyable
+#include <unordered_map> // unordered_map
+#include <vector>        // vector
+
+namespace ac
+{
+    /*!
+     * @class DiskHashTbl
+     * @brief An extendible hash table stored in fixed-size pages of a file.
+     *
+     * @note Each bucket is one page of the file. An in-memory directory of 2^global_depth
+     * slots maps the low bits of a key's (mixed) hash to its page, so a lookup reads at most
+     * one page. When a page overflows it is split in two by one more hash bit (its local
+     * depth); only when the page's local depth already equals the global depth does the
+     * directory double, and even then no other page is touched. Erased entries leave room in
+     * their page, but pages are never merged.
+     *
+     * Pages are read through an LRU cache of a bounded number of pages; modified pages are
+     * written back when evicted or on flush(). The directory and the file header are written
+     * by flush() and by the destructor: a table is only consistent on disk after one of them
+     * (there is no journal). A table object is not thread safe.
+     *
+     * Both KeyType and DataType must be trivially copyable (e.g. `PackedKey` and `float`), and
+     * KeyHash must give the same value for a key in every run of the program.
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class DiskHashTbl {
+        static_assert( std::is_trivially_copyable< KeyType >::value, "DiskHashTbl keys must be trivially copyable" );
+        static_assert( std::is_trivially_copyable< DataType >::value, "DiskHashTbl data must be trivially copyable" );
+
+        public:
+            // Aliases
+            using size_type = std::size_t; //!< The size type.
+
+            static constexpr size_type PAGE_SIZE = 4096; //!< Bytes per page of the file.
+            static constexpr size_type DEFAULT_CACHE_PAGES = 256; //!< Default number of cached pages (1 MiB).
+            static constexpr unsigned MAX_DEPTH = 28; //!< Largest global depth (a 2 GiB directory).
+
+            /*!
+             * @brief Creates a new file holding an empty table.
+             *
+             * A std::runtime_error is thrown if the file already exists or cannot be created.
+             *
+             * @param path_ The path of the file.
+             * @param cache_pages_ The number of pages kept in memory (at least 2).
+             * @return DiskHashTbl The table.
+             */
+            static DiskHashTbl create( const std::string & path_, size_type cache_pages_ = DEFAULT_CACHE_PAGES );
+
+            /*!
+             * @brief Opens a table saved in a file.
+             *
+             * A std::runtime_error is thrown if the file cannot be read or does not hold a table of this type.
+             *
+             * @param path_ The path of the file.
+             * @param cache_pages_ The number of pages kept in memory (at least 2).
+             * @return DiskHashTbl The table.
+             */
+            static DiskHashTbl open( const std::string & path_, size_type cache_pages_ = DEFAULT_CACHE_PAGES );
+
+            /*!
+             * @brief Removes the file of a table, which must not be open.
+             * @param path_ The path of the file.
+             * @return bool True if the file was removed, False if it did not exist.
+             */
+            static bool remove( const std::string & path_ );
+
+            /*!
+             * @brief Move constructor, takes over the file of another table object.
+             * @param other The table to be moved.
+             */
+            DiskHashTbl( DiskHashTbl && other ) noexcept;
+
+            /*!
+             * @brief Move assignment operator, closes the current file and takes over the file of another table object.
+             * @param other The table to be moved.
+             * @return DiskHashTbl& Reference to the current table.
+             */
+            DiskHashTbl& operator=( DiskHashTbl && other ) noexcept;
+
+            DiskHashTbl( const DiskHashTbl & ) = delete;
+            DiskHashTbl& operator=( const DiskHashTbl & ) = delete;
+
+            /*!
+             * @brief Destructor, flushes the table and closes the file.
+             */
+            ~DiskHashTbl();
+
+            /*!
+             * @brief Inserts a new entry or updates the data of an existing one.
+             *
+             * A std::length_error is thrown, before any split, if more keys than a page holds share
+             * the same MAX_DEPTH hash bits, since no split could ever separate them.
+             *
+             * @param key_ The key of the entry.
+             * @param new_data_ The data of the entry.
+             * @return bool True if the key was inserted, False if it was updated.
+             */
+            bool insert( const KeyType & key_, const DataType & new_data_ );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Removes an entry from the table.
+             * @param key_ The key of the entry to be removed.
+             * @return bool True if the entry is removed, False if the key is not found.
+             */
+            bool erase( const KeyType & key_ );
+
+            /*!
+             * @brief Calls a function on every entry of the table, one page at a time.
+             * @param fn_ A function that takes `(const KeyType&, const DataType&)`.
+             */
+            template< typename Function >
+            void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Writes the modified pages, the directory and the header to the file.
+             */
+            void flush();
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            bool empty() const { return size() == 0; }
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            size_type size() const { return m_header.m_count; }
+
+            /*!
+             * @brief Returns the number of hash bits used by the directory.
+             * @return unsigned The global depth.
+             */
+            unsigned global_depth() const { return m_header.m_global_depth; }
+
+            /*!
+             * @brief Returns the number of bucket pages in the file.
+             * @return size_type The number of bucket pages.
+             */
+            size_type page_count() const { return m_header.m_n_pages - 1; }
+
+            /*!
+             * @brief Returns the number of pages read from the file since the table was opened.
+             * @return size_type The number of page reads.
+             */
+            size_type page_reads() const { return m_reads; }
+
+            /*!
+             * @brief Returns the number of pages written to the file since the table was opened.
+             * @return size_type The number of page writes.
+             */
+            size_type page_writes() const { return m_writes; }
+
+        private:
+            /// An entry stored in a page.
+            struct Entry {
+                KeyType m_key;   //!< The key.
+                DataType m_data; //!< The data.
+            };
+
+            /// The header of a bucket page, followed by its entries.
+            struct PageHeader {
+                std::uint32_t m_local_depth; //!< Number of hash bits shared by the keys of the page.
+                std::uint32_t m_count;       //!< Number of entries in the page.
+            };
+
+            /// The header of the file, in page 0.
+            struct FileHeader {
+                std::uint32_t m_magic;        //!< Tag that identifies a table file.
+                std::uint32_t m_page_size;    //!< PAGE_SIZE, to detect a mismatch.
+                std::uint32_t m_entry_size;   //!< sizeof(Entry), to detect a mismatch of types.
+                std::uint32_t m_global_depth; //!< Number of hash bits used by the directory.
+                std::uint64_t m_n_pages;      //!< Number of pages, counting page 0.
+                std::uint64_t m_count;        //!< Number of entries.
+                std::uint64_t m_dir_page;     //!< First page of the saved directory.
+            };
+
+            /// A cached page.
+            struct Frame {
+                std::uint64_t m_page;                   //!< Page number.
+                bool m_dirty;                           //!< Whether the page differs from the file.
+                std::unique_ptr< unsigned char[] > m_bytes; //!< Contents of the page.
+            };
+
+            static constexpr size_type SLOTS = ( PAGE_SIZE - sizeof( PageHeader ) ) / sizeof( Entry ); //!< Entries per page.
+            static_assert( SLOTS >= 2, "DiskHashTbl entries must fit at least two to a page" );
+
+            /*!
+             * @brief Wraps an open file.
+             * @param fd_ The file descriptor.
+             * @param cache_pages_ The number of pages kept in memory.
+             */
+            DiskHashTbl( int fd_, size_type cache_pages_ );
+
+            static PageHeader * page_header( Frame & f_ ) { return reinterpret_cast< PageHeader * >( f_.m_bytes.get() ); }
+            static Entry * entries( Frame & f_ ) { return reinterpret_cast< Entry * >( f_.m_bytes.get() + sizeof( PageHeader ) ); }
+
+            /// Mixed hash of a key.
+            static std::uint64_t hash_of( const KeyType & key_ );
+
+            /// Page of a hash.
+            std::uint64_t page_of( std::uint64_t hash_ ) const
+            {
+                return m_dir[ hash_ & ( ( std::uint64_t{1} << m_header.m_global_depth ) - 1 ) ];
+            }
+
+            /*!
+             * @brief Returns a page from the cache, reading it (and evicting the least recently used page) if needed.
+             * @param page_ The page number.
+             * @return Frame& The cached page, now the most recently used.
+             */
+            Frame & fetch( std::uint64_t page_ ) const;
+
+            /*!
+             * @brief Appends a new, empty page to the file.
+             * @param local_depth_ The local depth of the page.
+             * @return Frame& The cached page.
+             */
+            Frame & allocate( std::uint32_t local_depth_ );
+
+            /*!
+             * @brief Makes room for one more page in the cache, writing back the evicted page if modified.
+             */
+            void make_room() const;
+
+            /*!
+             * @brief Splits a full page by one more hash bit, doubling the directory if needed.
+             * @param page_ The page number.
+             */
+            void split( std::uint64_t page_ );
+
+            /*!
+             * @brief Finds the slot of a key in a page.
+             * @param f_ The page.
+             * @param key_ The key.
+             * @return size_type The slot, or the number of entries of the page if the key is not there.
+             */
+            static size_type find( Frame & f_, const KeyType & key_ );
+
+            void write_frame( const Frame & f_ ) const;
+            void read_at( void * buf_, size_type bytes_, std::uint64_t offset_ ) const;
+            void write_at( const void * buf_, size_type bytes_, std::uint64_t offset_ ) const;
+
+            /*!
+             * @brief Flushes the table and closes the file, if any.
+             */
+            void close_file() noexcept;
+
+        private:
+            int m_fd{ -1 }; //!< The file descriptor (-1 once moved from).
+            FileHeader m_header{}; //!< The file header.
+            std::vector< std::uint64_t > m_dir; //!< The directory: page number of each combination of hash bits.
+            size_type m_cache_pages{ 0 }; //!< Maximum number of cached pages.
+            mutable std::list< Frame > m_frames; //!< The cached pages, most recently used first.
+            mutable std::unordered_map< std::uint64_t, typename std::list< Frame >::iterator > m_where; //!< Cached page of each page number.
+            mutable size_type m_reads{ 0 }; //!< Pages read from the file.
+            mutable size_type m_writes{ 0 }; //!< Pages written to the file.
+            static constexpr std::uint32_t MAGIC = 0x4c42544b; //!< Tag that identifies a table file.
+    };
+
+} // namespace ac
+#include "disk_hashtbl.inl"
+#endif
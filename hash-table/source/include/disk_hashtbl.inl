@@ -0,0 +1,409 @@
+#include "disk_hashtbl.h"
+
+#include <fcntl.h>  // open, O_CREAT, O_EXCL, O_RDWR
+#include <unistd.h> // pread, pwrite, close, unlink
+
+#include <algorithm> // max, copy
+#include <cerrno>    // errno, EINTR
+#include <cstring>   // strerror, memset
+#include <utility>   // exchange, move
+
+#include "hash_mix.h"
+
+namespace ac
+{
+    /// Create.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::create(const std::string &path_, size_type cache_pages_)
+    {
+        int fd = ::open(path_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+            throw std::runtime_error("DiskHashTbl: cannot create " + path_ + ": " + std::strerror(errno));
+
+        DiskHashTbl table{fd, cache_pages_};
+        table.m_header.m_magic = MAGIC;
+        table.m_header.m_page_size = PAGE_SIZE;
+        table.m_header.m_entry_size = sizeof(Entry);
+        table.m_header.m_n_pages = 1;
+
+        // a single page of local depth 0 holds every key
+        table.m_dir.assign(1, table.allocate(0).m_page);
+        table.flush();
+        return table;
+    }
+
+    /// Open.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::open(const std::string &path_, size_type cache_pages_)
+    {
+        int fd = ::open(path_.c_str(), O_RDWR);
+        if (fd < 0)
+            throw std::runtime_error("DiskHashTbl: cannot open " + path_ + ": " + std::strerror(errno));
+
+        DiskHashTbl table{fd, cache_pages_};
+        FileHeader &h = table.m_header;
+        try
+        {
+            table.read_at(&h, sizeof(FileHeader), 0);
+            if (h.m_magic != MAGIC || h.m_page_size != PAGE_SIZE || h.m_entry_size != sizeof(Entry) ||
+                h.m_global_depth > MAX_DEPTH || h.m_dir_page < h.m_n_pages)
+                throw std::runtime_error("DiskHashTbl: " + path_ + " does not hold a table of this type");
+
+            table.m_dir.resize(std::size_t{1} << h.m_global_depth);
+            table.read_at(table.m_dir.data(), table.m_dir.size() * sizeof(std::uint64_t), h.m_dir_page * PAGE_SIZE);
+        }
+        catch (...)
+        {
+            // closed without the flush of the destructor, which would overwrite the file
+            table.m_fd = -1;
+            ::close(fd);
+            throw;
+        }
+        return table;
+    }
+
+    /// Remove.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::remove(const std::string &path_)
+    {
+        return ::unlink(path_.c_str()) == 0;
+    }
+
+    /// Constructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::DiskHashTbl(int fd_, size_type cache_pages_)
+        : m_fd{fd_}, m_cache_pages{std::max<size_type>(cache_pages_, 2)}
+    {
+        /* empty */
+    }
+
+    /// Move constructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::DiskHashTbl(DiskHashTbl &&other) noexcept
+        : m_fd{std::exchange(other.m_fd, -1)}, m_header{other.m_header}, m_dir{std::move(other.m_dir)},
+          m_cache_pages{other.m_cache_pages}, m_frames{std::move(other.m_frames)}, m_where{std::move(other.m_where)},
+          m_reads{other.m_reads}, m_writes{other.m_writes}
+    {
+        /* empty */
+    }
+
+    /// Move assignment.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(DiskHashTbl &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close_file();
+            m_fd = std::exchange(other.m_fd, -1);
+            m_header = other.m_header;
+            m_dir = std::move(other.m_dir);
+            m_cache_pages = other.m_cache_pages;
+            m_frames = std::move(other.m_frames);
+            m_where = std::move(other.m_where);
+            m_reads = other.m_reads;
+            m_writes = other.m_writes;
+        }
+        return *this;
+    }
+
+    /// Destructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::~DiskHashTbl()
+    {
+        close_file();
+    }
+
+    /// Insert.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        std::uint64_t hash = hash_of(key_);
+
+        // each split frees room in the key's page, unless every key went to the same half
+        for (;;)
+        {
+            Frame &f = fetch(page_of(hash));
+            PageHeader *ph = page_header(f);
+            size_type slot = find(f, key_);
+
+            if (slot < ph->m_count || ph->m_count < SLOTS)
+            {
+                bool inserted = slot == ph->m_count;
+                // zero the padding too, since the whole entry is written to the file
+                Entry &e = entries(f)[slot];
+                std::memset(static_cast<void *>(&e), 0, sizeof(Entry));
+                e.m_key = key_;
+                e.m_data = new_data_;
+                f.m_dirty = true;
+                if (inserted)
+                {
+                    ++ph->m_count;
+                    ++m_header.m_count;
+                }
+                return inserted;
+            }
+
+            // no split can separate keys that agree on every bit a split could still use
+            std::uint64_t differ{0};
+            for (std::uint32_t i{0}; i < ph->m_count; ++i)
+                differ |= hash_of(entries(f)[i].m_key) ^ hash;
+            if (((differ & ((std::uint64_t{1} << MAX_DEPTH) - 1)) >> ph->m_local_depth) == 0)
+                throw std::length_error("DiskHashTbl: more than a page of keys share the same hash");
+
+            split(f.m_page);
+        }
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        Frame &f = fetch(page_of(hash_of(key_)));
+        size_type slot = find(f, key_);
+        if (slot == page_header(f)->m_count)
+            return false;
+
+        data_item_ = entries(f)[slot].m_data;
+        return true;
+    }
+
+    /// Erase.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        Frame &f = fetch(page_of(hash_of(key_)));
+        PageHeader *ph = page_header(f);
+        size_type slot = find(f, key_);
+        if (slot == ph->m_count)
+            return false;
+
+        // the last entry of the page fills the hole
+        entries(f)[slot] = entries(f)[ph->m_count - 1];
+        --ph->m_count;
+        --m_header.m_count;
+        f.m_dirty = true;
+        return true;
+    }
+
+    /// For each.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        for (std::uint64_t page{1}; page < m_header.m_n_pages; ++page)
+        {
+            Frame &f = fetch(page);
+            const Entry *e = entries(f);
+            for (size_type i{0}; i < page_header(f)->m_count; ++i)
+                fn_(e[i].m_key, e[i].m_data);
+        }
+    }
+
+    /// Flush.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::flush()
+    {
+        for (auto &f : m_frames)
+        {
+            if (f.m_dirty)
+            {
+                write_frame(f);
+                f.m_dirty = false;
+            }
+        }
+
+        // the directory goes right after the last page, where the next new page will overwrite it
+        m_header.m_dir_page = m_header.m_n_pages;
+        write_at(m_dir.data(), m_dir.size() * sizeof(std::uint64_t), m_header.m_dir_page * PAGE_SIZE);
+        write_at(&m_header, sizeof(FileHeader), 0);
+    }
+
+    /// Hash of a key.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint64_t DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::hash_of(const KeyType &key_)
+    {
+        // the directory uses the low bits, which must be well mixed
+        KeyHash hash;
+        return mix64(hash(key_));
+    }
+
+    /// Fetch.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Frame &
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::fetch(std::uint64_t page_) const
+    {
+        auto found = m_where.find(page_);
+        if (found != m_where.end())
+        {
+            m_frames.splice(m_frames.begin(), m_frames, found->second);
+            return m_frames.front();
+        }
+
+        make_room();
+        Frame f{page_, false, std::unique_ptr<unsigned char[]>(new unsigned char[PAGE_SIZE])};
+        read_at(f.m_bytes.get(), PAGE_SIZE, page_ * PAGE_SIZE);
+        ++m_reads;
+
+        m_frames.push_front(std::move(f));
+        m_where[page_] = m_frames.begin();
+        return m_frames.front();
+    }
+
+    /// Allocate.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Frame &
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::allocate(std::uint32_t local_depth_)
+    {
+        make_room();
+        Frame f{m_header.m_n_pages++, true, std::unique_ptr<unsigned char[]>(new unsigned char[PAGE_SIZE])};
+        std::memset(f.m_bytes.get(), 0, PAGE_SIZE);
+        page_header(f)->m_local_depth = local_depth_;
+
+        m_frames.push_front(std::move(f));
+        m_where[m_frames.front().m_page] = m_frames.begin();
+        return m_frames.front();
+    }
+
+    /// Make room.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::make_room() const
+    {
+        if (m_frames.size() < m_cache_pages)
+            return;
+
+        // the least recently used page is the victim
+        const Frame &victim = m_frames.back();
+        if (victim.m_dirty)
+            write_frame(victim);
+        m_where.erase(victim.m_page);
+        m_frames.pop_back();
+    }
+
+    /// Split.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::split(std::uint64_t page_)
+    {
+        Frame &old = fetch(page_);
+        std::uint32_t depth = page_header(old)->m_local_depth;
+
+        if (depth == m_header.m_global_depth)
+        {
+            if (depth == MAX_DEPTH)
+                throw std::length_error("DiskHashTbl: the directory cannot grow any further");
+
+            // doubling: both halves of the new directory point to the same pages
+            size_type half = m_dir.size();
+            m_dir.resize(half * 2);
+            std::copy(m_dir.begin(), m_dir.begin() + half, m_dir.begin() + half);
+            ++m_header.m_global_depth;
+        }
+
+        // the most recently used page is never evicted, so old stays cached (the cache holds at least 2 pages)
+        Frame &sibling = allocate(depth + 1);
+        PageHeader *oh = page_header(old);
+        PageHeader *sh = page_header(sibling);
+        Entry *oe = entries(old);
+        Entry *se = entries(sibling);
+
+        // the keys with the new hash bit set move to the sibling
+        std::uint32_t kept{0};
+        for (std::uint32_t i{0}; i < oh->m_count; ++i)
+        {
+            if ((hash_of(oe[i].m_key) >> depth) & 1)
+                se[sh->m_count++] = oe[i];
+            else
+                oe[kept++] = oe[i];
+        }
+        oh->m_count = kept;
+        oh->m_local_depth = depth + 1;
+        old.m_dirty = true;
+
+        for (size_type i{0}; i < m_dir.size(); ++i)
+            if (m_dir[i] == page_ && ((i >> depth) & 1))
+                m_dir[i] = sibling.m_page;
+    }
+
+    /// Find.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find(Frame &f_, const KeyType &key_)
+    {
+        KeyEqual equal;
+        const Entry *e = entries(f_);
+        size_type n = page_header(f_)->m_count;
+        for (size_type i{0}; i < n; ++i)
+            if (equal(e[i].m_key, key_))
+                return i;
+        return n;
+    }
+
+    /// Write frame.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::write_frame(const Frame &f_) const
+    {
+        write_at(f_.m_bytes.get(), PAGE_SIZE, f_.m_page * PAGE_SIZE);
+        ++m_writes;
+    }
+
+    /// Read at.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::read_at(void *buf_, size_type bytes_, std::uint64_t offset_) const
+    {
+        auto *p = static_cast<unsigned char *>(buf_);
+        while (bytes_ > 0)
+        {
+            ssize_t n = ::pread(m_fd, p, bytes_, static_cast<off_t>(offset_));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                throw std::runtime_error(std::string("DiskHashTbl: cannot read the file: ") +
+                                         (n < 0 ? std::strerror(errno) : "unexpected end of file"));
+            p += n;
+            bytes_ -= static_cast<size_type>(n);
+            offset_ += static_cast<std::uint64_t>(n);
+        }
+    }
+
+    /// Write at.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::write_at(const void *buf_, size_type bytes_, std::uint64_t offset_) const
+    {
+        auto *p = static_cast<const unsigned char *>(buf_);
+        while (bytes_ > 0)
+        {
+            ssize_t n = ::pwrite(m_fd, p, bytes_, static_cast<off_t>(offset_));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                throw std::runtime_error(std::string("DiskHashTbl: cannot write the file: ") + std::strerror(errno));
+            p += n;
+            bytes_ -= static_cast<size_type>(n);
+            offset_ += static_cast<std::uint64_t>(n);
+        }
+    }
+
+    /// Close file.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void DiskHashTbl<KeyType, DataType, KeyHash, KeyEqual>::close_file() noexcept
+    {
+        if (m_fd < 0)
+            return;
+
+        // a destructor cannot report the error; call flush() first to see it
+        try
+        {
+            flush();
+        }
+        catch (const std::exception &)
+        {
+        }
+        ::close(m_fd);
+        m_fd = -1;
+        m_frames.clear();
+        m_where.clear();
+    }
+
+} // namespace ac
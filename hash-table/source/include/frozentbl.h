@@ -0,0 +1,140 @@
+/*!
+ * @brief This file contains the declaration of the FrozenTbl class.
+ *
+ * FrozenTbl is a read-only dictionary built from the contents of a HashTbl. It uses a
+ * minimal perfect hash function (CHD/PTHash style), so every lookup inspects exactly one slot.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file frozentbl.h
+ */
+
+#ifndef FROZENTBL_H
+#define FROZENTBL_H
+
+#include <cstdint>   // std::uint32_t, std::uint64_t
+#include <iostream>  // istream, ostream
+#include <stdexcept> // out_of_range, runtime_error
+#include <vector>    // vector
+
+#include "hashtbl.h"
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @class FrozenTbl
+     * @brief An immutable hash table in which each key is mapped to its own slot.
+     *
+     * @note The keys are split into small groups by their hash value. During construction a
+     * "pilot" value is searched for each group, such that the pilot scatters the keys of the
+     * group into slots not yet taken. The table stores only the pilots (one 32-bit word per
+     * group, about one per four keys) and the entries, laid out in a single array.
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class FrozenTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>; //!< The type of individual entries in the table.
+            using table_type = HashTbl<KeyType,DataType,KeyHash,KeyEqual>; //!< The type of table that may be frozen.
+            using size_type  = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Default constructor, creates an empty table.
+             */
+            FrozenTbl() = default;
+
+            /*!
+             * @brief Builds the perfect hash over the entries of a hash table.
+             *
+             * If two different keys have the very same hash value, no pilot can separate them and
+             * a std::runtime_error is thrown.
+             *
+             * @param source The hash table to be frozen.
+             */
+            explicit FrozenTbl( const table_type & source );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Accesses the data associated with a given key.
+             *
+             * If the key is not found, an out of range exception is thrown.
+             *
+             * @param key_ The key of the item to be accessed.
+             * @return const DataType& Reference to the data associated with the key.
+             */
+            const DataType& at( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            bool empty() const { return m_slots.empty(); }
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            size_type size() const { return m_slots.size(); }
+
+            /*!
+             * @brief Writes the table to a binary stream, so it can be loaded without rebuilding the hash.
+             *
+             * Both KeyType and DataType must be trivially copyable.
+             *
+             * @param os_ The output stream (opened in binary mode).
+             */
+            void save( std::ostream & os_ ) const;
+
+            /*!
+             * @brief Reads a table previously written by save().
+             *
+             * Both KeyType and DataType must be trivially copyable and default constructible.
+             * A std::runtime_error is thrown if the stream does not hold a valid table.
+             *
+             * @param is_ The input stream (opened in binary mode).
+             * @return FrozenTbl The loaded table.
+             */
+            static FrozenTbl load( std::istream & is_ );
+
+        private:
+            /*!
+             * @brief Finds the slot of a key from its (mixed) hash value.
+             * @param hash_ The mixed hash value of the key.
+             * @return size_type The slot index.
+             */
+            size_type slot_of( std::uint64_t hash_ ) const;
+
+            /*!
+             * @brief Finds the slot of a key given the pilot of its group.
+             * @param hash_ The mixed hash value of the key.
+             * @param pilot_ The pilot of the group.
+             * @param n_slots_ The number of slots in the table.
+             * @return size_type The slot index.
+             */
+            static size_type slot_of( std::uint64_t hash_, std::uint32_t pilot_, size_type n_slots_ );
+
+        private:
+            std::vector< std::uint32_t > m_pilots; //!< One pilot for each group of keys.
+            std::vector< entry_type > m_slots; //!< The entries, in slot order.
+            static constexpr size_type KEYS_PER_GROUP = 4; //!< Average number of keys in a group.
+            static constexpr std::uint32_t MAGIC = 0x5a465441; //!< Tag that identifies a saved table.
+    };
+
+} // namespace ac
+#include "frozentbl.inl"
+#endif
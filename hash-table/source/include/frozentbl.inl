@@ -0,0 +1,214 @@
+#include "frozentbl.h"
+
+#include <algorithm> // stable_sort
+#include <numeric>   // iota
+#include <limits>    // numeric_limits
+#include <type_traits> // is_trivially_copyable
+
+namespace ac
+{
+    /// Constructor from a hash table.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::FrozenTbl(const table_type &source)
+    {
+        KeyHash hash;
+
+        size_type n = source.size();
+        if (n == 0)
+            return;
+
+        // collects the entries of the source table along with their mixed hash values
+        std::vector<const entry_type *> entries;
+        std::vector<std::uint64_t> hashes;
+        entries.reserve(n);
+        hashes.reserve(n);
+        source.for_each([&](const entry_type &entry) {
+            entries.push_back(&entry);
+            hashes.push_back(mix64(hash(entry.m_key)));
+        });
+
+        // splits the keys into groups of (on average) KEYS_PER_GROUP keys
+        size_type n_groups = (n + KEYS_PER_GROUP - 1) / KEYS_PER_GROUP;
+        std::vector<std::vector<size_type>> groups(n_groups);
+        for (size_type i{0}; i < n; ++i)
+            groups[hashes[i] % n_groups].push_back(i);
+
+        // the largest groups are placed first, while there are still many free slots
+        std::vector<size_type> order(n_groups);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_type a, size_type b) {
+            return groups[a].size() > groups[b].size();
+        });
+
+        m_pilots.assign(n_groups, 0);
+        std::vector<bool> taken(n, false);
+        std::vector<size_type> owner(n); // index of the entry placed in each slot
+        std::vector<size_type> candidate;
+
+        for (auto g : order)
+        {
+            const auto &members = groups[g];
+            // the remaining groups are empty
+            if (members.empty())
+                break;
+
+            // keys with the same hash value would always collide, whatever the pilot
+            for (size_type i{0}; i < members.size(); ++i)
+                for (size_type j{i + 1}; j < members.size(); ++j)
+                    if (hashes[members[i]] == hashes[members[j]])
+                        throw std::runtime_error("FrozenTbl: two keys have the same hash value");
+
+            // tries each pilot until all keys of the group land on distinct free slots
+            for (std::uint64_t pilot{0};; ++pilot)
+            {
+                if (pilot > std::numeric_limits<std::uint32_t>::max())
+                    throw std::runtime_error("FrozenTbl: could not find a pilot for a group of keys");
+
+                candidate.clear();
+                bool fits{true};
+                for (auto m : members)
+                {
+                    size_type slot = slot_of(hashes[m], static_cast<std::uint32_t>(pilot), n);
+                    if (taken[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end())
+                    {
+                        fits = false;
+                        break;
+                    }
+                    candidate.push_back(slot);
+                }
+
+                if (fits)
+                {
+                    for (size_type i{0}; i < members.size(); ++i)
+                    {
+                        taken[candidate[i]] = true;
+                        owner[candidate[i]] = members[i];
+                    }
+                    m_pilots[g] = static_cast<std::uint32_t>(pilot);
+                    break;
+                }
+            }
+        }
+
+        // lays out the entries in slot order
+        m_slots.reserve(n);
+        for (size_type slot{0}; slot < n; ++slot)
+            m_slots.push_back(*entries[owner[slot]]);
+    }
+
+    /// Slot of a key given the pilot of its group.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::slot_of(std::uint64_t hash_, std::uint32_t pilot_, size_type n_slots_)
+    {
+        return mix64(hash_, pilot_) % n_slots_;
+    }
+
+    /// Slot of a key.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::slot_of(std::uint64_t hash_) const
+    {
+        return slot_of(hash_, m_pilots[hash_ % m_pilots.size()], m_slots.size());
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        KeyHash hash;
+        KeyEqual equal;
+
+        if (m_slots.empty())
+            return false;
+
+        // the only slot where the key may be stored
+        const auto &entry = m_slots[slot_of(mix64(hash(key_)))];
+        if (equal(entry.m_key, key_))
+        {
+            data_item_ = entry.m_data;
+            return true;
+        }
+
+        return false;
+    }
+
+    /// At.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    const DataType &FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_) const
+    {
+        KeyHash hash;
+        KeyEqual equal;
+
+        if (!m_slots.empty())
+        {
+            const auto &entry = m_slots[slot_of(mix64(hash(key_)))];
+            if (equal(entry.m_key, key_))
+                return entry.m_data;
+        }
+
+        throw std::out_of_range("Key not found");
+    }
+
+    /// Save.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::save(std::ostream &os_) const
+    {
+        static_assert(std::is_trivially_copyable<KeyType>::value && std::is_trivially_copyable<DataType>::value,
+                      "FrozenTbl::save() requires trivially copyable keys and data");
+
+        std::uint64_t n_slots = m_slots.size();
+        std::uint64_t n_groups = m_pilots.size();
+
+        // header: tag, number of slots and number of groups
+        os_.write(reinterpret_cast<const char *>(&MAGIC), sizeof(MAGIC));
+        os_.write(reinterpret_cast<const char *>(&n_slots), sizeof(n_slots));
+        os_.write(reinterpret_cast<const char *>(&n_groups), sizeof(n_groups));
+
+        // the pilots, followed by each key and its data
+        os_.write(reinterpret_cast<const char *>(m_pilots.data()), n_groups * sizeof(std::uint32_t));
+        for (const auto &entry : m_slots)
+        {
+            os_.write(reinterpret_cast<const char *>(&entry.m_key), sizeof(KeyType));
+            os_.write(reinterpret_cast<const char *>(&entry.m_data), sizeof(DataType));
+        }
+    }
+
+    /// Load.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>
+    FrozenTbl<KeyType, DataType, KeyHash, KeyEqual>::load(std::istream &is_)
+    {
+        static_assert(std::is_trivially_copyable<KeyType>::value && std::is_trivially_copyable<DataType>::value,
+                      "FrozenTbl::load() requires trivially copyable keys and data");
+
+        std::uint32_t magic{0};
+        std::uint64_t n_slots{0};
+        std::uint64_t n_groups{0};
+
+        is_.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+        is_.read(reinterpret_cast<char *>(&n_slots), sizeof(n_slots));
+        is_.read(reinterpret_cast<char *>(&n_groups), sizeof(n_groups));
+        if (!is_ || magic != MAGIC || (n_slots == 0) != (n_groups == 0))
+            throw std::runtime_error("FrozenTbl: invalid stream");
+
+        FrozenTbl table;
+        table.m_pilots.resize(n_groups);
+        is_.read(reinterpret_cast<char *>(table.m_pilots.data()), n_groups * sizeof(std::uint32_t));
+
+        table.m_slots.reserve(n_slots);
+        for (std::uint64_t i{0}; i < n_slots; ++i)
+        {
+            KeyType key;
+            DataType data;
+            is_.read(reinterpret_cast<char *>(&key), sizeof(KeyType));
+            is_.read(reinterpret_cast<char *>(&data), sizeof(DataType));
+            table.m_slots.push_back(entry_type(key, data));
+        }
+
+        if (!is_)
+            throw std::runtime_error("FrozenTbl: truncated stream");
+
+        return table;
+    }
+} // Namespace ac.
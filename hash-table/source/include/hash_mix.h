@@ -0,0 +1,102 @@
+/*!
+ * @brief This file contains small bit-mixing helpers shared by the hash based containers.
+ *
+ * The user supplied hash functors (e.g. `KeyHash`) often return values with poor
+ * low-order bits, so the containers that derive several indices from one hash value
+ * first pass it through a mixer.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file hash_mix.h
+ */
+
+#ifndef HASH_MIX_H
+#define HASH_MIX_H
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+namespace ac
+{
+    /*!
+     * @brief Scrambles the bits of a 64-bit value (splitmix64 finalizer).
+     * @param x_ The value to be scrambled.
+     * @return std::uint64_t The scrambled value.
+     */
+    constexpr std::uint64_t mix64( std::uint64_t x_ )
+    {
+        x_ ^= x_ >> 30;
+        x_ *= 0xbf58476d1ce4e5b9ULL;
+        x_ ^= x_ >> 27;
+        x_ *= 0x94d049bb133111ebULL;
+        x_ ^= x_ >> 31;
+        return x_;
+    }
+
+    /*!
+     * @brief Combines a hash value with a seed, producing a new independent-looking hash.
+     * @param hash_ The original hash value.
+     * @param seed_ The seed.
+     * @return std::uint64_t The seeded hash value.
+     */
+    constexpr std::uint64_t mix64( std::uint64_t hash_, std::uint64_t seed_ )
+    {
+        return mix64( hash_ ^ mix64( seed_ + 0x9e3779b97f4a7c15ULL ) );
+    }
+
+    /*!
+     * @brief Hashes a byte string with SipHash-2-4, a keyed hash that resists crafted collisions.
+     *
+     * Unlike mix64(), which only scrambles a hash already computed, the result depends on every
+     * byte through a secret key: without the key, an attacker cannot build keys that collide.
+     *
+     * @param data_ The bytes to be hashed.
+     * @param len_ The number of bytes.
+     * @param k0_ The first half of the 128-bit key.
+     * @param k1_ The second half of the 128-bit key.
+     * @return std::uint64_t The hash value.
+     */
+    inline std::uint64_t siphash24( const void * data_, std::size_t len_, std::uint64_t k0_, std::uint64_t k1_ )
+    {
+        auto rotl = []( std::uint64_t x, int b ) { return ( x << b ) | ( x >> ( 64 - b ) ); };
+        std::uint64_t v0 = 0x736f6d6570736575ULL ^ k0_;
+        std::uint64_t v1 = 0x646f72616e646f6dULL ^ k1_;
+        std::uint64_t v2 = 0x6c7967656e657261ULL ^ k0_;
+        std::uint64_t v3 = 0x7465646279746573ULL ^ k1_;
+        auto sip_round = [&] {
+            v0 += v1; v1 = rotl( v1, 13 ); v1 ^= v0; v0 = rotl( v0, 32 );
+            v2 += v3; v3 = rotl( v3, 16 ); v3 ^= v2;
+            v0 += v3; v3 = rotl( v3, 21 ); v3 ^= v0;
+            v2 += v1; v1 = rotl( v1, 17 ); v1 ^= v2; v2 = rotl( v2, 32 );
+        };
+
+        // the message is read in little-endian words of 8 bytes
+        const auto * p = static_cast< const unsigned char * >( data_ );
+        std::size_t full = len_ & ~std::size_t{7};
+        for ( std::size_t i{0}; i < full; i += 8 )
+        {
+            std::uint64_t m{0};
+            for ( int j{0}; j < 8; ++j )
+                m |= std::uint64_t{ p[i + j] } << ( 8 * j );
+            v3 ^= m;
+            sip_round();
+            sip_round();
+            v0 ^= m;
+        }
+
+        // the last word holds the remaining bytes and the length
+        std::uint64_t b = std::uint64_t{ len_ } << 56;
+        for ( std::size_t j{0}; full + j < len_; ++j )
+            b |= std::uint64_t{ p[full + j] } << ( 8 * j );
+        v3 ^= b;
+        sip_round();
+        sip_round();
+        v0 ^= b;
+
+        v2 ^= 0xff;
+        for ( int r{0}; r < 4; ++r )
+            sip_round();
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+} // namespace ac
+
+#endif
@@ -0,0 +1,130 @@
+/*!
+ * @brief This file contains the declaration and implementation of the HashRing class.
+ *
+ * HashRing assigns hash values to nodes by consistent hashing, so adding or removing one of
+ * N nodes reassigns only about 1/N of the hash values.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file hash_ring.h
+ */
+
+#ifndef HASH_RING_H
+#define HASH_RING_H
+
+#include <algorithm> // lower_bound, remove_if, sort
+#include <cstdint>   // std::uint32_t, std::uint64_t
+#include <stdexcept> // logic_error
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @class HashRing
+     * @brief A consistent hashing ring with virtual nodes.
+     *
+     * @note Each node is placed at several pseudo-random points ("virtual nodes") of a ring of
+     * 64-bit positions. A hash value belongs to the node of the first point at or after it,
+     * wrapping around the ring. The more virtual nodes, the more even the share of each node.
+     */
+    class HashRing {
+        public:
+            // Aliases
+            using node_type = std::uint32_t; //!< The node identifier type.
+            using size_type = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Creates an empty ring.
+             * @param vnodes_ The number of virtual nodes of each node.
+             */
+            explicit HashRing( size_type vnodes_ = 128 ) : m_vnodes{ vnodes_ == 0 ? 1 : vnodes_ } {}
+
+            /*!
+             * @brief Adds a node to the ring.
+             * @param node_ The node identifier.
+             * @return bool True if the node was added, False if it was already in the ring.
+             */
+            bool add( node_type node_ )
+            {
+                if ( contains( node_ ) )
+                    return false;
+
+                for ( size_type v{0}; v < m_vnodes; ++v )
+                    m_points.emplace_back( mix64( node_, v ), node_ );
+                std::sort( m_points.begin(), m_points.end() );
+                ++m_nodes;
+                return true;
+            }
+
+            /*!
+             * @brief Removes a node from the ring.
+             * @param node_ The node identifier.
+             * @return bool True if the node was removed, False if it was not in the ring.
+             */
+            bool remove( node_type node_ )
+            {
+                auto last = std::remove_if( m_points.begin(), m_points.end(),
+                                            [&]( const point_type & p ){ return p.second == node_; } );
+                if ( last == m_points.end() )
+                    return false;
+
+                m_points.erase( last, m_points.end() );
+                --m_nodes;
+                return true;
+            }
+
+            /*!
+             * @brief Checks if a node is in the ring.
+             * @param node_ The node identifier.
+             * @return bool True if the node is in the ring, False otherwise.
+             */
+            bool contains( node_type node_ ) const
+            {
+                for ( const auto & p : m_points )
+                    if ( p.second == node_ )
+                        return true;
+                return false;
+            }
+
+            /*!
+             * @brief Finds the node that owns a hash value.
+             *
+             * A std::logic_error is thrown if the ring has no nodes.
+             *
+             * @param hash_ The hash value (it should be well mixed, e.g. by mix64()).
+             * @return node_type The owner node.
+             */
+            node_type node_of( std::uint64_t hash_ ) const
+            {
+                if ( m_points.empty() )
+                    throw std::logic_error( "HashRing: the ring has no nodes" );
+
+                // first point at or after the hash, wrapping around the ring
+                auto it = std::lower_bound( m_points.begin(), m_points.end(), point_type{ hash_, 0 } );
+                return it == m_points.end() ? m_points.front().second : it->second;
+            }
+
+            /*!
+             * @brief Returns the number of nodes in the ring.
+             * @return size_type The number of nodes.
+             */
+            size_type size() const { return m_nodes; }
+
+            /*!
+             * @brief Checks if the ring has no nodes.
+             * @return bool True if the ring is empty, False otherwise.
+             */
+            bool empty() const { return m_nodes == 0; }
+
+        private:
+            using point_type = std::pair< std::uint64_t, node_type >; //!< A ring position and its node.
+
+            std::vector< point_type > m_points; //!< The virtual nodes, sorted by position.
+            size_type m_vnodes; //!< Number of virtual nodes of each node.
+            size_type m_nodes{ 0 }; //!< Number of nodes.
+    };
+
+} // namespace ac
+#endif
@@ -0,0 +1,203 @@
+/*!
+ * @brief This file contains the declaration of the HashSet class.
+ *
+ * HashSet is a variation of HashTbl in which the key is not stored on its own: it is extracted
+ * from the stored value by a projection function object (e.g. the one returning `Account::getKeyView()`).
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file hashset.h
+ */
+
+#ifndef HASHSET_H
+#define HASHSET_H
+
+#include <iostream>     // cout, endl, ostream
+#include <forward_list> // forward_list
+#include <functional>   // std::hash, std::equal_to
+#include <initializer_list>
+#include <stdexcept>    // out_of_range
+#include <type_traits>  // decay_t, invoke_result_t
+
+#include "primes.h"
+
+/// Namespace containing the associative container HashSet.
+namespace ac
+{
+    /// The key type produced by the projection KeyOf when applied to a ValueType.
+    template< class ValueType, class KeyOf >
+    using projected_key_t = std::decay_t< std::invoke_result_t< KeyOf, const ValueType & > >;
+
+    /*!
+     * @class HashSet
+     * @brief A hash table that stores only values, each one carrying its own key.
+     *
+     * @note Like HashTbl, this class implements an unordered dictionary through dynamic allocation of an
+     * array of lists, but each list node holds a single value. Keys are obtained on demand by applying
+     * KeyOf to a stored value, so the projection should be cheap (ideally returning a view to the fields
+     * of the value) and the key fields of a stored value must never be changed.
+     *
+     * @tparam ValueType The stored value type.
+     * @tparam KeyOf Function object that, given a value, returns its key.
+     * @tparam KeyHash The hash function, applied to the projected keys.
+     * @tparam KeyEqual The key comparison function, applied to the projected keys.
+     */
+    template< class ValueType,
+              class KeyOf,
+              class KeyHash = std::hash< projected_key_t< ValueType, KeyOf > >,
+              class KeyEqual = std::equal_to< projected_key_t< ValueType, KeyOf > > >
+    class HashSet {
+        public:
+            // Aliases
+            using key_type   = projected_key_t< ValueType, KeyOf >; //!< The (projected) key type.
+            using list_type  = std::forward_list< ValueType >; //!< The type of lists used to store values.
+            using size_type  = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Default constructor.
+             * @param table_sz_ The initial size of the table. Defaults to DEFAULT_SIZE.
+             */
+            explicit HashSet( size_type table_sz_ = DEFAULT_SIZE );
+
+            /*!
+             * @brief Copy constructor.
+             * @param source The HashSet object to be copied.
+             */
+            HashSet( const HashSet& source );
+
+            /*!
+             * @brief Constructs a hash set from an initializer list.
+             *
+             * If two values of the list have the same key, the last one is kept.
+             *
+             * @param ilist The initializer list of values.
+             */
+            HashSet( const std::initializer_list< ValueType > & ilist );
+
+            /*!
+             * @brief Overloaded assignment operator that assigns another hash set to the current one.
+             * @param clone The hash set to be copied.
+             * @return HashSet& A reference to the updated hash set.
+             */
+            HashSet& operator=( const HashSet& clone );
+
+            /*!
+             * @brief Destructor.
+             */
+            virtual ~HashSet();
+
+            /*!
+             * @brief Inserts a new value in the table.
+             *
+             * If a value with the same key already exists, it is overwritten.
+             *
+             * @param value_ The value to be inserted.
+             * @return bool True if the insertion is successful, False if the key already exists in the table.
+             */
+            bool insert( const ValueType & value_ );
+
+            /*!
+             * @brief Retrieves the value associated with a given key.
+             * @param key_ The key to search for.
+             * @param value_ The variable to store the retrieved value.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const key_type & key_, ValueType & value_ ) const;
+
+            /*!
+             * @brief Erases the value associated with a given key.
+             * @param key_ The key of the value to be erased.
+             * @return bool True if the erasure is successful, False if the key is not found.
+             */
+            bool erase( const key_type & key_ );
+
+            /*!
+             * @brief Removes all values from the table.
+             */
+            void clear();
+
+            /*!
+             * @brief Checks if the hash set is empty.
+             * @return bool True if the hash set is empty, False otherwise.
+             */
+            bool empty() const { return m_count == 0; }
+
+            /*!
+             * @brief Returns the number of values in the hash set.
+             * @return size_type The number of values.
+             */
+            size_type size() const { return m_count; }
+
+            /*!
+             * @brief Accesses the value associated with a given key.
+             *
+             * If the key is not found, an out of range exception is thrown.
+             * The fields that make up the key must not be modified through the returned reference.
+             *
+             * @param key_ The key of the value to be accessed.
+             * @return ValueType& Reference to the stored value.
+             */
+            ValueType& at( const key_type & key_ );
+
+            /*!
+             * @brief Provides the count of values in the collision list associated with a given key.
+             * @param key_ The given key for the count.
+             * @return size_type The number of values in the list.
+             */
+            size_type count( const key_type & key_ ) const;
+
+            /*!
+             * @brief Applies a function to every value stored in the table.
+             * @tparam Function A function object callable with `const ValueType &`.
+             * @param fn_ The function to be applied.
+             */
+            template < typename Function >
+            void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Returns the maximum load factor of the hash set.
+             * @return float The maximum load factor.
+             */
+            float max_load_factor() const { return m_max_load_factor; }
+
+            /*!
+             * @brief Sets the maximum load factor of the hash set.
+             * @param mlf The new maximum load factor.
+             */
+            void max_load_factor( float mlf ) { m_max_load_factor = mlf; }
+
+            /*!
+             * @brief Overloaded << operator to display the hash set.
+             * @param os_ The output stream.
+             * @param hs_ The hash set from which values will be inserted into the stream.
+             * @return std::ostream& Reference to the output stream after inserting the values.
+             */
+            friend std::ostream & operator<<( std::ostream & os_, const HashSet & hs_ ) {
+                for (size_type i{0}; i < hs_.m_size; ++i) {
+                    os_ << "[" << i << "]-> ";
+                    for (const auto& value : hs_.m_table[i])
+                        os_ << value << " ";
+                    os_ << "\n";
+                }
+                return os_;
+            }
+
+        private:
+            /*!
+             * @brief Adjusts the table when the load factor exceeds the maximum load factor value.
+             *
+             * The new table size is the smallest prime number greater than or equal to twice the
+             * current size. List nodes are relinked, not copied.
+             */
+            void rehash( void );
+
+        private:
+            size_type m_size; //!< The size of the table.
+            size_type m_count;//!< The number of values in the table.
+            float m_max_load_factor; //!< The maximum load factor value.
+            list_type *m_table; //!< Table of lists of values.
+            static const short DEFAULT_SIZE = 11;
+    };
+
+} // namespace ac
+#include "hashset.inl"
+#endif
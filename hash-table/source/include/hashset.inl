@@ -0,0 +1,230 @@
+#include "hashset.h"
+
+namespace ac
+{
+    /// Regular constructor
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::HashSet(size_type sz)
+    {
+        m_size = next_prime(sz);
+        m_count = 0;
+        m_table = new list_type[m_size];
+        m_max_load_factor = 1.0;
+    }
+
+    /// Copy constructor
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::HashSet(const HashSet &source)
+    {
+        m_size = source.m_size;
+        m_count = source.m_count;
+        m_table = new list_type[m_size];
+        m_max_load_factor = source.m_max_load_factor;
+
+        // copies the collision lists from source
+        for (size_type i{0}; i < m_size; ++i)
+            m_table[i] = source.m_table[i];
+    }
+
+    /// Initializer constructor
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::HashSet(const std::initializer_list<ValueType> &ilist)
+    {
+        m_size = next_prime(ilist.size());
+        m_count = 0;
+        m_table = new list_type[m_size];
+        m_max_load_factor = 1.0;
+
+        for (const auto &value : ilist)
+            insert(value);
+    }
+
+    /// Overloaded assignment operator.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual> &
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::operator=(const HashSet &clone)
+    {
+        // avoids self-assignment
+        if (this != &clone)
+        {
+            clear();
+            // if the sizes differ, memory allocation is required
+            if (clone.m_size != m_size)
+            {
+                delete[] m_table;
+                m_size = clone.m_size;
+                m_table = new list_type[m_size];
+            }
+
+            m_max_load_factor = clone.m_max_load_factor;
+            m_count = clone.m_count;
+
+            for (size_type i{0}; i < m_size; ++i)
+                m_table[i] = clone.m_table[i];
+        }
+
+        return *this;
+    }
+
+    /// Destructor.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::~HashSet()
+    {
+        delete[] m_table;
+    }
+
+    /// Insert.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    bool HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::insert(const ValueType &value_)
+    {
+        KeyOf key_of;
+        KeyHash hash;
+        KeyEqual equal;
+
+        const auto &key = key_of(value_);
+        size_type pos = hash(key) % m_size;
+        // if a value with the same key is found, it is overwritten
+        for (auto &value : m_table[pos])
+        {
+            if (equal(key_of(value), key))
+            {
+                value = value_;
+                return false;
+            }
+        }
+
+        m_table[pos].push_front(value_);
+        ++m_count;
+
+        // if the load factor is greater than the maximum load factor, rehashing is required
+        if (m_count > m_size * m_max_load_factor)
+            rehash();
+
+        return true;
+    }
+
+    /// Retrieve.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    bool HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::retrieve(const key_type &key_, ValueType &value_) const
+    {
+        KeyOf key_of;
+        KeyHash hash;
+        KeyEqual equal;
+
+        size_type pos = hash(key_) % m_size;
+        for (const auto &value : m_table[pos])
+        {
+            if (equal(key_of(value), key_))
+            {
+                value_ = value;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// Erase.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    bool HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::erase(const key_type &key_)
+    {
+        KeyOf key_of;
+        KeyHash hash;
+        KeyEqual equal;
+
+        size_type pos = hash(key_) % m_size;
+        // iterator to the node before the value to be erased
+        auto prev = m_table[pos].before_begin();
+        for (const auto &value : m_table[pos])
+        {
+            if (equal(key_of(value), key_))
+            {
+                m_table[pos].erase_after(prev);
+                --m_count;
+                return true;
+            }
+            ++prev;
+        }
+
+        return false;
+    }
+
+    /// Clear.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    void HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::clear()
+    {
+        for (size_type i{0}; i < m_size; ++i)
+            m_table[i].clear();
+        m_count = 0;
+    }
+
+    /// At.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    ValueType &HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::at(const key_type &key_)
+    {
+        KeyOf key_of;
+        KeyHash hash;
+        KeyEqual equal;
+
+        size_type pos = hash(key_) % m_size;
+        for (auto &value : m_table[pos])
+        {
+            if (equal(key_of(value), key_))
+                return value;
+        }
+
+        throw std::out_of_range("Key not found");
+    }
+
+    /// Counts the number of values in a list.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    typename HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::size_type
+    HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::count(const key_type &key_) const
+    {
+        KeyHash hash;
+
+        size_type pos = hash(key_) % m_size;
+        size_type count{0};
+        for (auto it = m_table[pos].begin(); it != m_table[pos].end(); ++it)
+            ++count;
+
+        return count;
+    }
+
+    /// For each.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    void HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        for (size_type i{0}; i < m_size; ++i)
+        {
+            for (const auto &value : m_table[i])
+                fn_(value);
+        }
+    }
+
+    /// Rehash.
+    template <typename ValueType, typename KeyOf, typename KeyHash, typename KeyEqual>
+    void HashSet<ValueType, KeyOf, KeyHash, KeyEqual>::rehash(void)
+    {
+        KeyOf key_of;
+        KeyHash hash;
+
+        size_type new_size = next_prime(m_size * 2);
+        list_type *aux = new list_type[new_size];
+
+        // moves each node to the front of its new list, without copying the values
+        for (size_type i{0}; i < m_size; ++i)
+        {
+            while (!m_table[i].empty())
+            {
+                size_type pos = hash(key_of(m_table[i].front())) % new_size;
+                aux[pos].splice_after(aux[pos].before_begin(), m_table[i], m_table[i].before_begin());
+            }
+        }
+
+        delete[] m_table;
+        m_size = new_size;
+        m_table = aux;
+    }
+} // Namespace ac.
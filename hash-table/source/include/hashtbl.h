@@ -17,11 +17,43 @@
 #include <cmath>        // sqrt
 #include <iterator>     // std::begin(), std::end()
 #include <initializer_list>
-#include <utility> // std::pair
+#include <utility> // std::pair, std::move
+#include <new>     // placement new, std::launder
+#include <random>  // std::random_device
+#include <system_error> // std::system_error
+#include <thread>  // std::thread
+#include <type_traits> // std::true_type, std::void_t
+#include <vector>  // std::vector
+
+#include "hash_mix.h"
+#include "primes.h"
+
+// Opt-in latency instrumentation: define AC_HASHTBL_INSTRUMENT to time every insert, retrieve,
+// erase, at and operator[] call (see latency_histogram.h). Otherwise the macro expands to nothing.
+#if defined(AC_HASHTBL_INSTRUMENT)
+#include "latency_histogram.h"
+#define AC_HASHTBL_TIMED(op) ac::OpTimer ac_op_timer_{ ac::HashTblOp::op }
+#else
+#define AC_HASHTBL_TIMED(op)
+#endif
 
 /// Namespace containing the associative container HashTbl.
 namespace ac 
 {
+    /*!
+     * @brief Tells whether a hash functor has a seeded overload, `operator()(const KeyType&, std::uint64_t seed)`.
+     * @tparam KeyHash The hash functor.
+     * @tparam KeyType The key type.
+     */
+    template< class KeyHash, class KeyType, class = void >
+    struct has_seeded_hash : std::false_type {};
+
+    template< class KeyHash, class KeyType >
+    struct has_seeded_hash< KeyHash, KeyType,
+                            std::void_t< decltype( std::declval< const KeyHash & >()( std::declval< const KeyType & >(),
+                                                                                      std::uint64_t{} ) ) > >
+        : std::true_type {};
+
     /*!
      * @struct HashEntry
      * @brief The HashEntry struct represents a single entry in the hash table that associates a key with data.
@@ -59,6 +91,24 @@ namespace ac
      * @brief A template class representing a hash table container.
      *
      * @note This class implements an unordered dictionary through dynamic allocation of an array of lists of table entries.
+     * Small tables keep their first INLINE_CAPACITY entries inside the table object itself, found by a linear scan,
+     * and allocate the array of lists only when they outgrow it. While the entries are inline, the table still
+     * tracks the size it would have (so count() and operator<< report the same buckets), and references to entries
+     * are invalidated by erase() and by the insertion that moves the entries to the heap.
+     *
+     * Optionally (see hot_cache()), the lookups of a table whose entries live in the lists go through a small
+     * direct-mapped cache of (hash, entry address) pairs, so a repeated lookup of a hot key skips the walk of its
+     * list. Nodes are never copied by a rehash, so only erase() and clear() invalidate cached addresses. Since
+     * retrieve() then updates the cache, concurrent const calls are no longer safe on such a table.
+     *
+     * Every insertion measures the list it walks. If a list grows beyond chain_limit() entries, and beyond
+     * CHAIN_LIMIT_LOADS times max_load_factor() (the expected length of a list), e.g. because keys were crafted to
+     * collide under a predictable KeyHash, the table switches to a random seed and redistributes its entries at
+     * once. When a new seed does not shorten that list, the chain limit is raised instead of reseeding again.
+     *
+     * A seeded table hashes with `KeyHash::operator()(key, seed)` when KeyHash has that overload (which should be
+     * a keyed hash such as siphash24()); otherwise it can only scramble the unseeded hash with the seed, which
+     * spreads keys whose hashes differ but not keys whose hashes are equal.
      *
      * @tparam KeyType The key type.
      * @tparam DataType The data type.
@@ -176,6 +226,16 @@ namespace ac
              */
             DataType& at( const KeyType& key_);
 
+            /*!
+             * @brief Accesses the data associated with a given key, without copying it.
+             *
+             * If the key is not found, an out of range exception is thrown.
+             *
+             * @param key_ The key of the item to be accessed.
+             * @return const DataType& Reference to the data associated with the key.
+             */
+            const DataType& at( const KeyType& key_) const;
+
             /*!
              * @brief Accesses the data associated with a given key of the hash table using the square bracket.
              * 
@@ -194,7 +254,30 @@ namespace ac
             size_type count( const KeyType& key_) const;
 
             /*!
-             * @brief Returns the maximum load factor of the hash table. 
+             * @brief Applies a function to every entry stored in the table.
+             *
+             * The entries are visited list by list, in no particular order.
+             *
+             * @tparam Function A function object callable with `const entry_type &`.
+             * @param fn_ The function to be applied.
+             */
+            template < typename Function >
+            void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Checks if the entries are still stored inside the table object (no array of lists was allocated).
+             * @return bool True if the entries are inline, False otherwise.
+             */
+            bool is_inline() const { return m_table == nullptr; }
+
+            /*!
+             * @brief Returns the number of entries a table can store before allocating its array of lists.
+             * @return size_type The inline capacity.
+             */
+            static constexpr size_type inline_capacity() { return INLINE_CAPACITY; }
+
+            /*!
+             * @brief Returns the maximum load factor of the hash table.
              * @return float The maximum load factor.
              */
             float max_load_factor() const { return m_max_load_factor; }
@@ -205,6 +288,58 @@ namespace ac
              */
             void max_load_factor(float mlf) { m_max_load_factor = mlf; }
 
+            /*!
+             * @brief Returns the number of threads used to rehash large tables.
+             * @return size_type The number of threads.
+             */
+            size_type rehash_threads() const { return m_rehash_threads; }
+
+            /*!
+             * @brief Sets the number of threads used to rehash large tables.
+             *
+             * Tables with at least PARALLEL_REHASH_THRESHOLD entries are rehashed by this many threads,
+             * which needs about 8 more bytes per entry while it lasts. A value of 0 or 1 (the default) keeps
+             * the rehash on the calling thread, e.g. for a table used while holding a lock. If a thread
+             * cannot be started, the calling thread does its share.
+             *
+             * @param n_threads_ The number of threads.
+             */
+            void rehash_threads(size_type n_threads_) { m_rehash_threads = n_threads_; }
+
+            /*!
+             * @brief Returns the list length beyond which the table reseeds its hash (if also beyond
+             * CHAIN_LIMIT_LOADS times max_load_factor()).
+             * @return size_type The chain limit (0 if the monitoring is disabled).
+             */
+            size_type chain_limit() const { return m_chain_limit; }
+
+            /*!
+             * @brief Sets the list length beyond which the table reseeds its hash.
+             * @param limit_ The chain limit, or 0 to disable the monitoring.
+             */
+            void chain_limit(size_type limit_) { m_chain_limit = limit_; }
+
+            /*!
+             * @brief Returns how many times the table has reseeded its hash.
+             * @return size_type The number of reseeds.
+             */
+            size_type reseeds() const { return m_reseeds; }
+
+            /*!
+             * @brief Returns the number of slots of the hot-key cache.
+             * @return size_type The number of slots (0 if the cache is disabled).
+             */
+            size_type hot_cache() const { return m_cache == nullptr ? 0 : m_cache_mask + 1; }
+
+            /*!
+             * @brief Enables, resizes or disables the hot-key cache.
+             *
+             * Each slot takes two words; a few dozen slots fit in the L1 cache. The cache starts empty.
+             *
+             * @param slots_ The number of slots (rounded up to a power of two), or 0 to disable the cache.
+             */
+            void hot_cache(size_type slots_);
+
             /*!
              * @brief Overloaded << operator to display hash table.
              * @param os_ The output stream.
@@ -215,9 +350,16 @@ namespace ac
                 // for each linked list in the table...
                 for (size_t i{0}; i < ht_.m_size; ++i) {
                     os_ << "[" << i << "]-> ";
-                    // for each element in the linked list, print the data of the entry
-                    for (const auto& entry : ht_.m_table[i]) 
-                        os_ << entry.m_data << " ";
+                    if (ht_.is_inline()) {
+                        // the inline entries of this list, newest first (as push_front would leave them)
+                        for (size_t k{ht_.m_count}; k > 0; --k)
+                            if (ht_.hash_of(ht_.inline_entries()[k - 1].m_key) % ht_.m_size == i)
+                                os_ << ht_.inline_entries()[k - 1].m_data << " ";
+                    } else {
+                        // for each element in the linked list, print the data of the entry
+                        for (const auto& entry : ht_.m_table[i]) 
+                            os_ << entry.m_data << " ";
+                    }
                     os_ << "\n";
                 }
                 return os_;
@@ -225,38 +367,125 @@ namespace ac
 
         private:
             /*!
-             * @brief Finds the next prime number greater or equal than the given number. 
-             * @param n_ The given number.
-             * @return size_type The next prime number.
+             * @brief Adjusts the table when the load factor exceeds the maximum load factor value.
+             *
+             * The items in the table are redistributed according to the new table size, which corresponds to the smallest 
+             * prime number greater than or equal to twice the size of the table before the rehash() call.
+             *
+             */
+            void rehash( void );
+
+            /*!
+             * @brief Moves every entry into a new array of lists, by the current hash.
+             * @param new_size The size of the new array.
              */
-            static size_type find_next_prime( size_type n_ );
+            void redistribute( size_type new_size );
 
             /*!
-             * @brief Checks if a number is prime.
-             * 
-             * Uses the Sieve of Eratosthenes.
-             *
-             * @param n_ The number to check.
-             * @return bool True if the number is prime, false otherwise.
+             * @brief Hashes a key, with the seed of the table if it has one.
+             * @param key_ The key.
+             * @return size_type The hash value.
              */
-            static bool prime( size_type n_ ); 
+            size_type hash_of( const KeyType & key_ ) const;
 
             /*!
-             * @brief Adjusts the table when the load factor exceeds the maximum load factor value.
+             * @brief Tells whether a list of a given length calls for a reseed.
+             * @param length_ The number of entries of the list before an insertion.
+             * @return bool True if the length reaches both chain_limit() and CHAIN_LIMIT_LOADS times max_load_factor().
+             */
+            bool chain_too_long( size_type length_ ) const;
+
+            /*!
+             * @brief Switches to a new random seed and redistributes the entries, because a list grew too long.
+             * @param pos The list that grew too long, under the old hash.
+             */
+            void reseed( size_type pos );
+
+            /*!
+             * @brief Moves every entry of the current table into the lists of a new table, using several threads.
              *
-             * The items in the table are redistributed according to the new table size, which corresponds to the smallest 
-             * prime number greater than or equal to twice the size of the table before the rehash() call.
+             * First, each thread detaches the nodes of its share of the old lists into one parcel per thread,
+             * according to the range of new lists where each node must go. Then each thread relinks the nodes
+             * of the parcels addressed to it into its own range of new lists. No list is ever touched by two
+             * threads at the same time, and no entry is copied.
              *
+             * @param aux The new array of lists.
+             * @param new_size The size of the new array.
              */
-            void rehash( void );
+            void parallel_rehash( list_type *aux, size_type new_size );
+
+            /*!
+             * @brief Returns the entries stored inside the table object.
+             * @return entry_type* Pointer to the first inline entry.
+             */
+            entry_type * inline_entries() { return std::launder( reinterpret_cast< entry_type * >( m_inline ) ); }
+            const entry_type * inline_entries() const
+            {
+                return std::launder( reinterpret_cast< const entry_type * >( m_inline ) );
+            }
+
+            /*!
+             * @brief Finds an inline entry by a linear scan.
+             * @param key_ The key to search for.
+             * @return size_type The index of the entry, or m_count if the key is not found.
+             */
+            size_type find_inline( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Allocates the array of lists and moves the inline entries into it, in insertion order.
+             */
+            void spill( void );
+
+            /// A slot of the hot-key cache.
+            struct CacheSlot {
+                size_type m_hash; //!< Hash of the key of the entry.
+                entry_type * m_entry; //!< The entry, or nullptr if the slot is empty.
+            };
+
+            /*!
+             * @brief Returns the cache slot of a hash.
+             * @param hash_ The hash of a key.
+             * @return CacheSlot& The slot.
+             */
+            CacheSlot & cache_slot( size_type hash_ ) const { return m_cache[ mix64( hash_ ) & m_cache_mask ]; }
+
+            /*!
+             * @brief Looks up a key in the hot-key cache.
+             * @param key_ The key.
+             * @param hash_ The hash of the key.
+             * @return entry_type* The entry, or nullptr if the key is not cached (or the cache is disabled).
+             */
+            entry_type * find_cached( const KeyType & key_, size_type hash_ ) const;
+
+            /*!
+             * @brief Stores an entry in the hot-key cache, if enabled.
+             * @param hash_ The hash of the key of the entry.
+             * @param entry_ The entry.
+             */
+            void remember( size_type hash_, const entry_type & entry_ ) const;
 
         private:
             size_type m_size; //!< The size of the table.
             size_type m_count;//!< The number of elements in the table.
             float m_max_load_factor; //!< The maximum load factor value.
+            size_type m_rehash_threads; //!< The number of threads used to rehash large tables.
             // std::unique_ptr< std::forward_list< entry_type > [] > m_table;
-            std::forward_list< entry_type > *m_table; //!< Table of lists for table entries.
+            //! Table of lists for table entries (nullptr while the entries are inline).
+            std::forward_list< entry_type > *m_table;
             static const short DEFAULT_SIZE = 11;
+            //! Number of inline entries.
+            static constexpr size_type INLINE_CAPACITY = std::min< size_type >( 8, 512 / sizeof( entry_type ) );
+            //! Storage of the inline entries.
+            alignas( entry_type ) unsigned char m_inline[ ( INLINE_CAPACITY == 0 ? 1 : INLINE_CAPACITY )
+                                                          * sizeof( entry_type ) ];
+            static const size_type PARALLEL_REHASH_THRESHOLD = 1 << 16; //!< Minimum number of entries for a parallel rehash.
+            CacheSlot *m_cache{ nullptr }; //!< Slots of the hot-key cache (nullptr if disabled).
+            size_type m_cache_mask{ 0 }; //!< Number of cache slots - 1.
+            std::uint64_t m_seed{ 0 }; //!< Seed of the hash (0: KeyHash alone).
+            size_type m_chain_limit{ DEFAULT_CHAIN_LIMIT }; //!< List length that triggers a reseed (0: never).
+            size_type m_reseeds{ 0 }; //!< Number of reseeds so far.
+            static const size_type DEFAULT_CHAIN_LIMIT = 64; //!< Default chain limit.
+            static const size_type CHAIN_LIMIT_LOADS = 8; //!< Minimum chain limit, in multiples of the maximum load factor.
     };
 
 } // MyHashTable
@@ -6,11 +6,13 @@ namespace ac
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     HashTbl<KeyType, DataType, KeyHash, KeyEqual>::HashTbl(size_type sz)
     {
-        // dynamically allocates in *m_table an array whose size is determined to be the smallest prime number ≥ the value specified in sz
-        m_size = find_next_prime(sz);
+        // the size is the smallest prime number ≥ sz; the array of lists is only allocated when the
+        // inline entries overflow
+        m_size = next_prime(sz);
         m_count = 0;
-        m_table = new list_type[m_size];
+        m_table = nullptr;
         m_max_load_factor = 1.0;
+        m_rehash_threads = 1;
     }
 
     /// Copy constructor
@@ -20,10 +22,25 @@ namespace ac
         // updates the attributes according to source
         m_size = source.m_size;
         m_count = source.m_count;
-        m_table = new list_type[m_size];
+        m_table = nullptr;
         m_max_load_factor = source.m_max_load_factor;
+        m_rehash_threads = source.m_rehash_threads;
+        // the lists of the copy are laid out by the same hash
+        m_seed = source.m_seed;
+        m_chain_limit = source.m_chain_limit;
+        // the copy has a cache of the same size, but empty
+        hot_cache(source.hot_cache());
+
+        if (source.is_inline())
+        {
+            // copies the inline entries
+            for (size_type i{0}; i < m_count; ++i)
+                new (inline_entries() + i) entry_type(source.inline_entries()[i]);
+            return;
+        }
 
         // assigns the collision lists from source to the current table.
+        m_table = new list_type[m_size];
         for (auto i{0}; i < m_size; ++i)
             m_table[i] = source.m_table[i];
     }
@@ -33,10 +50,11 @@ namespace ac
     HashTbl<KeyType, DataType, KeyHash, KeyEqual>::HashTbl(const std::initializer_list<entry_type> &ilist)
     {
         // updates the attributes according to ilist
-        m_size = find_next_prime(ilist.size());
+        m_size = next_prime(ilist.size());
         m_count = 0;
-        m_table = new list_type[m_size];
+        m_table = nullptr;
         m_max_load_factor = 1.0;
+        m_rehash_threads = 1;
 
         // insert copies of the entries from ilist into the current table
         for (auto i{ilist.begin()}; i != ilist.end(); ++i)
@@ -52,15 +70,32 @@ namespace ac
         if (this != &clone)
         {
             clear();
+            m_max_load_factor = clone.m_max_load_factor;
+            m_rehash_threads = clone.m_rehash_threads;
+            m_seed = clone.m_seed;
+            m_chain_limit = clone.m_chain_limit;
+            hot_cache(clone.hot_cache());
+
+            if (clone.is_inline())
+            {
+                // the clone has no array of lists, so neither does the current table
+                delete[] m_table;
+                m_table = nullptr;
+                m_size = clone.m_size;
+                for (size_type i{0}; i < clone.m_count; ++i)
+                    new (inline_entries() + i) entry_type(clone.inline_entries()[i]);
+                m_count = clone.m_count;
+                return *this;
+            }
+
             // if the size of the current table and the received table are different, memory allocation is required
-            if (clone.m_size != m_size)
+            if (clone.m_size != m_size || is_inline())
             {
                 delete[] m_table;
                 m_size = clone.m_size;
                 m_table = new list_type[m_size];
             }
 
-            m_max_load_factor = clone.m_max_load_factor;
             m_count = clone.m_count;
 
             // assigns the collision lists from clone to the current table.
@@ -81,9 +116,10 @@ namespace ac
         // if the size of the current table and the received initializer list are different, memory allocation is required
         if (ilist.size() != m_size)
         {
+            // the entries start inline again
             delete[] m_table;
-            m_size = find_next_prime(ilist.size());
-            m_table = new list_type[m_size];
+            m_size = next_prime(ilist.size());
+            m_table = nullptr;
         }
 
         m_max_load_factor = 1.0;
@@ -103,18 +139,50 @@ namespace ac
         clear();
         // deallocates the memory associated with the array
         delete[] m_table;
+        delete[] m_cache;
     }
 
     /// Insert.
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
     {
-        KeyHash hash;
+        AC_HASHTBL_TIMED(INSERT);
         KeyEqual equal;
 
+        if (is_inline())
+        {
+            size_type i = find_inline(key_);
+            if (i < m_count)
+            {
+                inline_entries()[i].m_data = new_data_;
+                return false;
+            }
+
+            if (m_count < INLINE_CAPACITY)
+            {
+                // appends the new element after the other inline entries
+                new (inline_entries() + m_count) entry_type(key_, new_data_);
+                if (++m_count > m_size * m_max_load_factor)
+                    rehash();
+                return true;
+            }
+
+            // the inline storage is full: from now on the entries live in the lists
+            spill();
+        }
+
+        size_type h = hash_of(key_);
+        // a hot key is updated without walking its list
+        if (entry_type *cached = find_cached(key_, h))
+        {
+            cached->m_data = new_data_;
+            return false;
+        }
+
         // calculates the position of the list in which the new element will be inserted
-        size_type end = hash(key_) % m_size;
-        // searches in the list at the calculated position
+        size_type end = h % m_size;
+        // searches in the list at the calculated position, measuring its length on the way
+        size_type length{0};
         for (auto &entry : m_table[end])
         {
             // if the key is equal to the key of any element, returns false after updating the data
@@ -123,12 +191,17 @@ namespace ac
                 entry.m_data = new_data_;
                 return false;
             }
+            ++length;
         }
 
         // inserts the new element at the end of the list at the calculated position
         m_table[end].push_front(entry_type(key_, new_data_));
         ++m_count;
 
+        // a list this long means colliding keys: a new seed spreads them
+        if (chain_too_long(length))
+            reseed(end);
+
         // if the load factor is greater than the maximum load factor, rehashing is required
         if (m_count > m_size * m_max_load_factor)
             rehash();
@@ -140,10 +213,23 @@ namespace ac
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
     {
+        if (is_inline())
+        {
+            // destroys each inline entry
+            for (size_type i{0}; i < m_count; ++i)
+                inline_entries()[i].~entry_type();
+            m_count = 0;
+            return;
+        }
+
         // clears each collision list
         for (auto i{0}; i < m_size; ++i)
             m_table[i].clear();
         m_count = 0;
+
+        // no cached entry survives
+        for (size_type i{0}; m_cache != nullptr && i <= m_cache_mask; ++i)
+            m_cache[i].m_entry = nullptr;
     }
 
     /// Empty.
@@ -157,17 +243,34 @@ namespace ac
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
     {
-        KeyHash hash;
+        AC_HASHTBL_TIMED(RETRIEVE);
         KeyEqual equal;
 
+        if (is_inline())
+        {
+            size_type i = find_inline(key_);
+            if (i == m_count)
+                return false;
+            data_item_ = inline_entries()[i].m_data;
+            return true;
+        }
+
+        size_type h = hash_of(key_);
+        if (const entry_type *cached = find_cached(key_, h))
+        {
+            data_item_ = cached->m_data;
+            return true;
+        }
+
         // calculates the position of the list in which the searched element is located
-        size_type pos = hash(key_) % m_size;
+        size_type pos = h % m_size;
         // searches in the list at the calculated position
         for (auto &entry : m_table[pos])
         {
             // if the key is equal to the key of any element, updates the reference and returns true; otherwise, returns false
             if (equal(entry.m_key, key_))
             {
+                remember(h, entry);
                 data_item_ = entry.m_data;
                 return true;
             }
@@ -181,40 +284,133 @@ namespace ac
     void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::rehash(void)
     {
         // finds the new size of the list
-        size_type new_size = find_next_prime(m_size * 2);
+        size_type new_size = next_prime(m_size * 2);
+
+        // inline entries have no lists to move: only the size the table would have changes
+        if (is_inline())
+        {
+            m_size = new_size;
+            return;
+        }
 
-        size_type aux_count = m_count;
+        redistribute(new_size);
+    }
+
+    /// Redistribute.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::redistribute(size_type new_size)
+    {
         list_type *aux = new list_type[new_size];
 
-        KeyHash hash;
-        // places the items from the table in their new positions
-        for (auto i{0}; i < m_size; ++i)
+        if (m_count >= PARALLEL_REHASH_THRESHOLD && m_rehash_threads > 1)
+            parallel_rehash(aux, new_size);
+        else
         {
-            for (auto &entry : m_table[i])
+            // moves each node to its new position; the nodes are relinked, not copied
+            for (size_type i{0}; i < m_size; ++i)
             {
-                size_type pos = hash(entry.m_key) % new_size;
-                aux[pos].push_front(entry);
+                while (!m_table[i].empty())
+                {
+                    size_type pos = hash_of(m_table[i].front().m_key) % new_size;
+                    aux[pos].splice_after(aux[pos].before_begin(), m_table[i], m_table[i].before_begin());
+                }
             }
         }
 
-        // frees the previously used memory and updates the table to the current size and memory space
-        clear();
+        // frees the (now empty) lists and updates the table to the current size and memory space
         delete[] m_table;
         m_size = new_size;
         m_table = aux;
+    }
 
-        m_count = aux_count;
+    /// Parallel rehash.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::parallel_rehash(list_type *aux, size_type new_size)
+    {
+        size_type n_threads = m_rehash_threads;
+
+        // parcel[t * n_threads + p] holds the nodes detached by thread t that belong to the range of thread p,
+        // and target[t * n_threads + p] the new position of each of those nodes, in the order they were detached
+        std::vector<list_type> parcel(n_threads * n_threads);
+        std::vector<std::vector<size_type>> target(n_threads * n_threads);
+
+        // first phase: each thread empties its share of the old lists into the parcels
+        auto detach = [&](size_type t) {
+            size_type first = m_size * t / n_threads;
+            size_type last = m_size * (t + 1) / n_threads;
+            for (size_type i{first}; i < last; ++i)
+            {
+                while (!m_table[i].empty())
+                {
+                    size_type pos = hash_of(m_table[i].front().m_key) % new_size;
+                    size_type p = pos * n_threads / new_size;
+                    auto &box = parcel[t * n_threads + p];
+                    box.splice_after(box.before_begin(), m_table[i], m_table[i].before_begin());
+                    target[t * n_threads + p].push_back(pos);
+                }
+            }
+        };
+
+        // second phase: each thread relinks the nodes addressed to its range of new lists
+        auto relink = [&](size_type p) {
+            for (size_type t{0}; t < n_threads; ++t)
+            {
+                auto &box = parcel[t * n_threads + p];
+                const auto &pos = target[t * n_threads + p];
+                // the last node detached is at the front of the parcel
+                for (size_type k{pos.size()}; k > 0; --k)
+                    aux[pos[k - 1]].splice_after(aux[pos[k - 1]].before_begin(), box, box.before_begin());
+            }
+        };
+
+        // runs one phase on n_threads threads (the calling thread included) and waits for all of them;
+        // the shares of threads that cannot be started are run by the calling thread, so no node is lost
+        auto run = [n_threads](auto phase) {
+            std::vector<std::thread> workers;
+            size_type started{1};
+            try
+            {
+                for (; started < n_threads; ++started)
+                    workers.emplace_back(phase, started);
+            }
+            catch (const std::system_error &)
+            {
+            }
+            for (size_type t{started}; t < n_threads; ++t)
+                phase(t);
+            phase(0);
+            for (auto &worker : workers)
+                worker.join();
+        };
+
+        run(detach);
+        run(relink);
     }
 
     /// Erase.
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
     {
-        KeyHash hash;
+        AC_HASHTBL_TIMED(ERASE);
         KeyEqual equal;
 
+        if (is_inline())
+        {
+            size_type i = find_inline(key_);
+            if (i == m_count)
+                return false;
+
+            // shifts the following entries back, keeping the insertion order
+            auto *entries = inline_entries();
+            for (; i + 1 < m_count; ++i)
+                entries[i] = std::move(entries[i + 1]);
+            entries[--m_count].~entry_type();
+            return true;
+        }
+
         // calculates the position of the list in which the element to be deleted is located
-        size_type pos = hash(key_) % m_size;
+        size_type h = hash_of(key_);
+        size_type pos = h % m_size;
         // iterator to the element before the key to be deleted
         auto prev = m_table[pos].before_begin();
         // iterate over the list at position pos in the hash table
@@ -223,6 +419,9 @@ namespace ac
             // if key to be deleted is found erase the element after 'prev' and return true
             if (equal(entry.m_key, key_))
             {
+                // an entry can only be cached in the slot of its hash
+                if (m_cache != nullptr && cache_slot(h).m_entry == &entry)
+                    cache_slot(h).m_entry = nullptr;
                 m_table[pos].erase_after(prev);
                 --m_count;
                 return true;
@@ -233,93 +432,132 @@ namespace ac
         return false;
     }
 
-    /// Find next prime.
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    std::size_t HashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_next_prime(size_type n_)
-    {
-        // while n_ is not prime, increment and test again
-        while (!prime(n_))
-            ++n_;
-
-        return n_;
-    }
-
-    /// Prime checking.
-    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
-    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::prime(size_type n_)
-    {
-        // if n_ is less than or equal to 1, it's not prime
-        if (n_ <= 1)
-            return false;
-        // if n_ is greater than 1 and less than or equal to 3, it is prime
-        if (n_ <= 3)
-            return true;
-        // if n_ is divisible by 2 or 3, it's not prime
-        if (n_ % 2 == 0 || n_ % 3 == 0)
-            return false;
-
-        // tests if n_ is divisible by numbers of the form 6k + 1 and 6k - 1 (prime numbers) up to the square root of n_
-        for (auto i{5}; i * i <= n_; i += 6)
-        {
-            // if it is divisible, it is not prime
-            if (n_ % i == 0 || n_ % (i + 2) == 0)
-                return false;
-        }
-
-        return true;
-    }
-
     /// Counts the number of elements in a list.
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     typename HashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
     HashTbl<KeyType, DataType, KeyHash, KeyEqual>::count(const KeyType &key_) const
     {
-        KeyHash hash;
-        KeyEqual equal;
-
         // calculates the position of the list in which the searched element is located
-        size_type pos = hash(key_) % m_size;
+        size_type pos = hash_of(key_) % m_size;
         // counts the number of elements in the list at the calculated position
         size_type count{0};
+        if (is_inline())
+        {
+            // the inline entries that would be in that list
+            for (size_type i{0}; i < m_count; ++i)
+                if (hash_of(inline_entries()[i].m_key) % m_size == pos)
+                    ++count;
+            return count;
+        }
         for (auto &entry : m_table[pos])
             ++count;
 
         return count;
     }
 
+    /// For each.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        if (is_inline())
+        {
+            for (size_type i{0}; i < m_count; ++i)
+                fn_(inline_entries()[i]);
+            return;
+        }
+
+        // visits every entry of every collision list
+        for (size_type i{0}; i < m_size; ++i)
+        {
+            for (const auto &entry : m_table[i])
+                fn_(entry);
+        }
+    }
+
     /// At.
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
     {
-        KeyHash hash;
+        AC_HASHTBL_TIMED(SUBSCRIPT);
         KeyEqual equal;
 
+        if (is_inline())
+        {
+            size_type i = find_inline(key_);
+            if (i == m_count)
+                throw std::out_of_range("Key not found");
+            return inline_entries()[i].m_data;
+        }
+
+        size_type h = hash_of(key_);
+        if (entry_type *cached = find_cached(key_, h))
+            return cached->m_data;
+
         // calculates the position of the list in which the searched element is located
-        size_type pos = hash(key_) % m_size;
+        size_type pos = h % m_size;
         // searches for the item associated with the provided key
         for (auto &entry : m_table[pos])
         {
             if (equal(entry.m_key, key_))
+            {
+                remember(h, entry);
                 return entry.m_data;
+            }
         }
 
         throw std::out_of_range("Key not found");
     }
 
+    /// At (const).
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    const DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_) const
+    {
+        // the lookup changes nothing but the hot-key cache, which retrieve() updates too
+        return const_cast<HashTbl *>(this)->at(key_);
+    }
+
     /// Operator [].
     template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
     DataType &HashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
     {
-        KeyHash hash;
+        AC_HASHTBL_TIMED(SUBSCRIPT);
         KeyEqual equal;
+
+        if (is_inline())
+        {
+            size_type i = find_inline(key_);
+            if (i < m_count)
+                return inline_entries()[i].m_data;
+
+            if (m_count < INLINE_CAPACITY)
+            {
+                new (inline_entries() + m_count) entry_type(key_, DataType());
+                if (++m_count > m_size * m_max_load_factor)
+                    rehash();
+                return inline_entries()[i].m_data;
+            }
+
+            spill();
+        }
+
+        size_type h = hash_of(key_);
+        if (entry_type *cached = find_cached(key_, h))
+            return cached->m_data;
+
         // calculates the position of the list in which the searched element is located
-        size_type pos = hash(key_) % m_size;
+        size_type pos = h % m_size;
 
-        // searches for the item associated with the provided key
+        // searches for the item associated with the provided key, measuring the list on the way
+        size_type length{0};
         for (auto &entry : m_table[pos])
         {
             if (equal(entry.m_key, key_))
+            {
+                remember(h, entry);
                 return entry.m_data;
+            }
+            ++length;
         }
 
         // checks if, with the insertion, the load factor exceeds the maximum load factor
@@ -328,13 +566,141 @@ namespace ac
             // if it exceeds, performs rehashing and updates the position of
             // the linked list in which the inserted item is located
             rehash();
-            pos = hash(key_) % m_size;
+            pos = h % m_size;
         }
 
         // if the item associated with the provided key is not found,
         // performs the insertion of an item with the provided key and default data
         m_table[pos].push_front(entry_type(key_, DataType()));
+        entry_type &inserted = m_table[pos].front();
+
+        // the node is relinked, not copied, by a reseed
+        if (chain_too_long(length))
+            reseed(pos);
 
-        return m_table[pos].begin()->m_data;
+        return inserted.m_data;
+    }
+
+    /// Find inline.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_inline(const KeyType &key_) const
+    {
+        KeyEqual equal;
+
+        // a handful of entries: a linear scan is cheaper than hashing the key
+        size_type i{0};
+        while (i < m_count && !equal(inline_entries()[i].m_key, key_))
+            ++i;
+
+        return i;
+    }
+
+    /// Spill.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::spill(void)
+    {
+        // the entries are moved in insertion order, so each list ends up as if they had been inserted there
+        list_type *aux = new list_type[m_size];
+        auto *entries = inline_entries();
+        for (size_type i{0}; i < m_count; ++i)
+        {
+            aux[hash_of(entries[i].m_key) % m_size].push_front(std::move(entries[i]));
+            entries[i].~entry_type();
+        }
+
+        m_table = aux;
+    }
+
+    /// Hash of a key.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::hash_of(const KeyType &key_) const
+    {
+        KeyHash hash;
+        if (m_seed == 0)
+            return hash(key_);
+
+        if constexpr (has_seeded_hash<KeyHash, KeyType>::value)
+            return hash(key_, m_seed);
+        else
+            return mix64(hash(key_), m_seed);
+    }
+
+    /// Reseed.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::reseed(size_type pos)
+    {
+        // a seed the attacker cannot guess (0 is reserved for the unseeded hash)
+        std::random_device device;
+        std::uint64_t seed{0};
+        while (seed == 0)
+            seed = (std::uint64_t{device()} << 32) ^ device();
+
+        // the cache remembers hashes of the old seed
+        for (size_type i{0}; m_cache != nullptr && i <= m_cache_mask; ++i)
+            m_cache[i].m_entry = nullptr;
+
+        const KeyType &probe = m_table[pos].front().m_key;
+        size_type old_length = std::distance(m_table[pos].begin(), m_table[pos].end());
+        m_seed = seed;
+        ++m_reseeds;
+        redistribute(m_size);
+
+        // a new seed that does not shorten the list will not help next time either (e.g. keys with equal
+        // hashes and no seeded KeyHash): a higher limit avoids reseeding on every insertion
+        const list_type &list = m_table[hash_of(probe) % m_size];
+        size_type new_length = std::distance(list.begin(), list.end());
+        if (2 * new_length >= old_length)
+            m_chain_limit = std::max(m_chain_limit, old_length) * 2;
+    }
+
+    /// Chain too long.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool HashTbl<KeyType, DataType, KeyHash, KeyEqual>::chain_too_long(size_type length_) const
+    {
+        // lists are expected to be about max_load_factor() long, so the limit grows with it
+        return m_chain_limit != 0 && length_ >= m_chain_limit && length_ >= CHAIN_LIMIT_LOADS * m_max_load_factor;
+    }
+
+    /// Hot cache.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::hot_cache(size_type slots_)
+    {
+        delete[] m_cache;
+        m_cache = nullptr;
+        m_cache_mask = 0;
+        if (slots_ == 0)
+            return;
+
+        size_type n{1};
+        while (n < slots_)
+            n <<= 1;
+        m_cache = new CacheSlot[n]();
+        m_cache_mask = n - 1;
+    }
+
+    /// Find cached.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename HashTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type *
+    HashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_cached(const KeyType &key_, size_type hash_) const
+    {
+        if (m_cache == nullptr)
+            return nullptr;
+
+        // the hash rules out most other keys before the (costlier) key comparison
+        const CacheSlot &slot = cache_slot(hash_);
+        if (slot.m_entry != nullptr && slot.m_hash == hash_ && KeyEqual{}(slot.m_entry->m_key, key_))
+            return slot.m_entry;
+        return nullptr;
+    }
+
+    /// Remember.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void HashTbl<KeyType, DataType, KeyHash, KeyEqual>::remember(size_type hash_, const entry_type &entry_) const
+    {
+        // the entries belong to the table, so a const lookup may hand out a mutable address later
+        if (m_cache != nullptr)
+            cache_slot(hash_) = CacheSlot{hash_, const_cast<entry_type *>(&entry_)};
     }
 } // Namespace ac.
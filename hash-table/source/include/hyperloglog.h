@@ -0,0 +1,98 @@
+/*!
+ * @brief This file contains the declaration of the HyperLogLog class.
+ *
+ * HyperLogLog estimates the number of distinct keys in a stream using a few kilobytes,
+ * whatever the number of keys.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file hyperloglog.h
+ */
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <cstdint>    // std::uint8_t, std::uint64_t
+#include <functional> // hash
+#include <stdexcept>  // invalid_argument
+#include <vector>     // vector
+
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @class HyperLogLog
+     * @brief An approximate counter of distinct keys.
+     *
+     * @note The first `precision` bits of a key's mixed hash select one of 2^precision registers,
+     * which keeps the longest run of leading zeros seen in the remaining bits. The estimate
+     * is a bias-corrected harmonic mean of the registers, with a relative standard error of
+     * about 1.04 / sqrt(2^precision) (e.g. 1.6% with 4096 one-byte registers). Small counts are
+     * estimated by linear counting of the empty registers.
+     *
+     * Sketches with the same precision can be merged, e.g. one per thread, merged at the end.
+     *
+     * @tparam KeyType The key type.
+     * @tparam KeyHash The hash function.
+     */
+    template< class KeyType, class KeyHash = std::hash< KeyType > >
+    class HyperLogLog {
+        public:
+            // Aliases
+            using size_type = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Creates an empty sketch.
+             *
+             * A std::invalid_argument is thrown if the precision is not in [4, 18].
+             *
+             * @param precision_ The number of hash bits that select a register.
+             */
+            explicit HyperLogLog( unsigned precision_ = 12 );
+
+            /*!
+             * @brief Adds a key.
+             * @param key_ The key.
+             */
+            void add( const KeyType & key_ );
+
+            /*!
+             * @brief Estimates the number of distinct keys added.
+             * @return double The estimate.
+             */
+            double estimate() const;
+
+            /*!
+             * @brief Adds the keys of another sketch to this one.
+             *
+             * A std::invalid_argument is thrown if the sketches have different precisions.
+             *
+             * @param other The sketch to be merged.
+             */
+            void merge( const HyperLogLog & other );
+
+            /*!
+             * @brief Resets all the registers.
+             */
+            void clear();
+
+            /*!
+             * @brief Returns the number of hash bits that select a register.
+             * @return unsigned The precision.
+             */
+            unsigned precision() const { return m_precision; }
+
+            /*!
+             * @brief Returns the memory used by the registers.
+             * @return size_type The number of bytes.
+             */
+            size_type memory() const { return m_registers.size(); }
+
+        private:
+            std::vector< std::uint8_t > m_registers; //!< Longest run of leading zeros (plus one) of each register.
+            unsigned m_precision; //!< Number of hash bits that select a register.
+    };
+
+} // namespace ac
+#include "hyperloglog.inl"
+#endif
@@ -0,0 +1,94 @@
+#include "hyperloglog.h"
+
+#include <algorithm> // max, fill
+#include <cmath>     // ldexp, log
+
+namespace ac
+{
+    /// Constructor.
+    template <typename KeyType, typename KeyHash>
+    HyperLogLog<KeyType, KeyHash>::HyperLogLog(unsigned precision_) : m_precision{precision_}
+    {
+        if (precision_ < 4 || precision_ > 18)
+            throw std::invalid_argument("HyperLogLog: the precision must be in [4, 18]");
+
+        m_registers.assign(size_type{1} << precision_, 0);
+    }
+
+    /// Add.
+    template <typename KeyType, typename KeyHash>
+    void HyperLogLog<KeyType, KeyHash>::add(const KeyType &key_)
+    {
+        KeyHash hash;
+        std::uint64_t h = mix64(hash(key_));
+
+        // the top bits select the register, the position of the first 1 in the rest is the rank
+        size_type index = h >> (64 - m_precision);
+        std::uint64_t rest = h << m_precision;
+        std::uint8_t rank{1};
+        if (rest == 0)
+            rank = static_cast<std::uint8_t>(64 - m_precision + 1);
+        else
+        {
+#if defined(__GNUC__)
+            rank = static_cast<std::uint8_t>(__builtin_clzll(rest) + 1);
+#else
+            while ((rest & (std::uint64_t{1} << 63)) == 0)
+            {
+                rest <<= 1;
+                ++rank;
+            }
+#endif
+        }
+
+        m_registers[index] = std::max(m_registers[index], rank);
+    }
+
+    /// Estimate.
+    template <typename KeyType, typename KeyHash>
+    double HyperLogLog<KeyType, KeyHash>::estimate() const
+    {
+        const double m = static_cast<double>(m_registers.size());
+
+        double sum{0};
+        size_type zeros{0};
+        for (auto r : m_registers)
+        {
+            sum += std::ldexp(1.0, -r);
+            if (r == 0)
+                ++zeros;
+        }
+
+        // bias correction constant (Flajolet et al.)
+        double alpha = m_registers.size() == 16 ? 0.673
+                     : m_registers.size() == 32 ? 0.697
+                     : m_registers.size() == 64 ? 0.709
+                     : 0.7213 / (1.0 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+
+        // small counts: linear counting of the empty registers is more accurate
+        if (raw <= 2.5 * m && zeros > 0)
+            return m * std::log(m / static_cast<double>(zeros));
+
+        return raw;
+    }
+
+    /// Merge.
+    template <typename KeyType, typename KeyHash>
+    void HyperLogLog<KeyType, KeyHash>::merge(const HyperLogLog &other)
+    {
+        if (other.m_precision != m_precision)
+            throw std::invalid_argument("HyperLogLog: cannot merge sketches of different precisions");
+
+        for (size_type i{0}; i < m_registers.size(); ++i)
+            m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+    }
+
+    /// Clear.
+    template <typename KeyType, typename KeyHash>
+    void HyperLogLog<KeyType, KeyHash>::clear()
+    {
+        std::fill(m_registers.begin(), m_registers.end(), 0);
+    }
+
+} // namespace ac
@@ -0,0 +1,294 @@
+/*!
+ * @brief This file contains the LatencyHistogram class and the optional HashTbl instrumentation.
+ *
+ * LatencyHistogram records durations in a log-linear (HDR-style) histogram of fixed size.
+ * When AC_HASHTBL_INSTRUMENT is defined before including hashtbl.h, every insert, retrieve,
+ * erase and operator[] call of every HashTbl is timed into per-thread histograms, which
+ * HashTblStats merges on demand.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file latency_histogram.h
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm> // min, max
+#include <array>     // array
+#include <atomic>    // atomic
+#include <chrono>    // steady_clock
+#include <cmath>     // ceil
+#include <cstdint>   // std::uint64_t
+#include <mutex>     // mutex, lock_guard
+#include <vector>    // vector
+
+namespace ac
+{
+    /*!
+     * @class LatencyHistogram
+     * @brief A histogram of durations (in nanoseconds) with bounded relative error.
+     *
+     * @note Values below 2^SUB_BITS have a bucket each. Above that, each power of two is split
+     * into 2^SUB_BITS equal buckets, so a value is reported with a relative error below
+     * 1 / 2^SUB_BITS (about 1.6%) from 1 ns up to about 18 minutes (larger values are clamped).
+     * The counts live in a fixed array: recording never allocates.
+     *
+     * A single thread may record while other threads read the histogram (merge, percentiles):
+     * the counts are atomics updated without read-modify-write instructions.
+     */
+    class LatencyHistogram {
+        public:
+            // Aliases
+            using value_type = std::uint64_t; //!< The type of the recorded values (nanoseconds).
+            using size_type = std::size_t; //!< The size type.
+
+            static constexpr unsigned SUB_BITS = 6; //!< log2 of the number of buckets per power of two.
+            static constexpr unsigned MAX_BITS = 40; //!< Values are clamped below 2^MAX_BITS.
+
+            LatencyHistogram() { clear(); }
+
+            LatencyHistogram( const LatencyHistogram & other ) { clear(); merge( other ); }
+
+            LatencyHistogram& operator=( const LatencyHistogram & other )
+            {
+                if ( this != &other )
+                {
+                    clear();
+                    merge( other );
+                }
+                return *this;
+            }
+
+            /*!
+             * @brief Records one value (only one thread may record into a histogram).
+             * @param value_ The value, in nanoseconds.
+             */
+            void record( value_type value_ )
+            {
+                value_ = std::min( value_, MAX_VALUE );
+                bump( m_counts[ index_of( value_ ) ], 1 );
+                bump( m_total, 1 );
+                if ( value_ > m_max.load( std::memory_order_relaxed ) )
+                    m_max.store( value_, std::memory_order_relaxed );
+            }
+
+            /*!
+             * @brief Adds the values of another histogram to this one.
+             * @param other The histogram to be merged.
+             */
+            void merge( const LatencyHistogram & other )
+            {
+                for ( size_type i{0}; i < N_BUCKETS; ++i )
+                    bump( m_counts[i], other.m_counts[i].load( std::memory_order_relaxed ) );
+                bump( m_total, other.m_total.load( std::memory_order_relaxed ) );
+                m_max.store( std::max( max(), other.max() ), std::memory_order_relaxed );
+            }
+
+            /*!
+             * @brief Removes all the values.
+             */
+            void clear()
+            {
+                for ( auto & c : m_counts )
+                    c.store( 0, std::memory_order_relaxed );
+                m_total.store( 0, std::memory_order_relaxed );
+                m_max.store( 0, std::memory_order_relaxed );
+            }
+
+            /*!
+             * @brief Returns the number of values recorded.
+             * @return std::uint64_t The number of values.
+             */
+            std::uint64_t count() const { return m_total.load( std::memory_order_relaxed ); }
+
+            /*!
+             * @brief Returns the largest value recorded (exact, unless clamped).
+             * @return value_type The largest value, or 0 if there are none.
+             */
+            value_type max() const { return m_max.load( std::memory_order_relaxed ); }
+
+            /*!
+             * @brief Returns a percentile of the values.
+             * @param p_ The percentile, in [0, 100] (e.g. 99.9).
+             * @return value_type The largest value of the bucket holding the percentile (never above max()), or 0 if there are no values.
+             */
+            value_type percentile( double p_ ) const
+            {
+                std::uint64_t total = count();
+                if ( total == 0 )
+                    return 0;
+
+                // rank of the percentile among the sorted values (1-based)
+                auto rank = static_cast< std::uint64_t >( std::ceil( p_ / 100.0 * total ) );
+                rank = std::max< std::uint64_t >( 1, std::min( rank, total ) );
+
+                std::uint64_t seen{0};
+                for ( size_type i{0}; i < N_BUCKETS; ++i )
+                {
+                    seen += m_counts[i].load( std::memory_order_relaxed );
+                    if ( seen >= rank )
+                        return std::min( highest_in( i ), max() );
+                }
+                return max();
+            }
+
+        private:
+            static constexpr size_type SUB_COUNT = size_type{1} << SUB_BITS; //!< Buckets per power of two.
+            static constexpr size_type N_BUCKETS = SUB_COUNT * ( MAX_BITS - SUB_BITS + 1 ); //!< Number of buckets.
+            static constexpr value_type MAX_VALUE = ( value_type{1} << MAX_BITS ) - 1; //!< Largest value kept.
+
+            /// Adds to a counter written by a single thread (no locked instruction).
+            static void bump( std::atomic< std::uint64_t > & c_, std::uint64_t n_ )
+            {
+                c_.store( c_.load( std::memory_order_relaxed ) + n_, std::memory_order_relaxed );
+            }
+
+            /// Bucket of a value.
+            static size_type index_of( value_type v_ )
+            {
+                if ( v_ < SUB_COUNT )
+                    return static_cast< size_type >( v_ );
+
+                // v_ >> shift lies in [SUB_COUNT, 2 * SUB_COUNT)
+#if defined(__GNUC__)
+                unsigned msb = 63 - static_cast< unsigned >( __builtin_clzll( v_ ) );
+#else
+                unsigned msb{0};
+                for ( value_type x{v_}; x > 1; x >>= 1 )
+                    ++msb;
+#endif
+                unsigned shift = msb - SUB_BITS;
+                return SUB_COUNT * ( shift + 1 ) + static_cast< size_type >( ( v_ >> shift ) - SUB_COUNT );
+            }
+
+            /// Largest value that falls in a bucket.
+            static value_type highest_in( size_type i_ )
+            {
+                if ( i_ < SUB_COUNT )
+                    return i_;
+
+                unsigned shift = static_cast< unsigned >( i_ / SUB_COUNT - 1 );
+                value_type lowest = static_cast< value_type >( SUB_COUNT + i_ % SUB_COUNT ) << shift;
+                return lowest + ( value_type{1} << shift ) - 1;
+            }
+
+            std::array< std::atomic< std::uint64_t >, N_BUCKETS > m_counts; //!< Number of values in each bucket.
+            std::atomic< std::uint64_t > m_total; //!< Number of values.
+            std::atomic< value_type > m_max; //!< Largest value.
+    };
+
+    /// The HashTbl operations that are timed (SUBSCRIPT counts both at() and operator[]).
+    enum class HashTblOp { INSERT = 0, RETRIEVE, ERASE, SUBSCRIPT };
+
+    /*!
+     * @class HashTblStats
+     * @brief Registry of the per-thread latency histograms of the HashTbl operations.
+     *
+     * @note Each thread records into its own histograms, registered on first use. When a thread
+     * ends, its histograms are merged into the registry, so no value is lost.
+     */
+    class HashTblStats {
+        public:
+            static constexpr std::size_t N_OPS = 4; //!< Number of timed operations.
+            using snapshot_type = std::array< LatencyHistogram, N_OPS >; //!< One histogram per operation.
+
+            /*!
+             * @brief Records the duration of an operation on the calling thread.
+             * @param op_ The operation.
+             * @param ns_ The duration, in nanoseconds.
+             */
+            static void record( HashTblOp op_, std::uint64_t ns_ )
+            {
+                thread_local Local local;
+                local.m_ops[ static_cast< std::size_t >( op_ ) ].record( ns_ );
+            }
+
+            /*!
+             * @brief Merges the histograms of all the threads, one per operation.
+             * @return snapshot_type The merged histograms, indexed by HashTblOp.
+             */
+            static snapshot_type snapshot()
+            {
+                auto & r = registry();
+                std::lock_guard< std::mutex > guard{ r.m_lock };
+                snapshot_type result = r.m_retired;
+                for ( auto * local : r.m_live )
+                    for ( std::size_t op{0}; op < N_OPS; ++op )
+                        result[op].merge( local->m_ops[op] );
+                return result;
+            }
+
+            /*!
+             * @brief Clears the histograms of all the threads (values being recorded meanwhile may survive).
+             */
+            static void reset()
+            {
+                auto & r = registry();
+                std::lock_guard< std::mutex > guard{ r.m_lock };
+                for ( auto & h : r.m_retired )
+                    h.clear();
+                for ( auto * local : r.m_live )
+                    for ( auto & h : local->m_ops )
+                        h.clear();
+            }
+
+        private:
+            /// The histograms of one thread.
+            struct Local {
+                snapshot_type m_ops;
+
+                Local()
+                {
+                    auto & r = registry();
+                    std::lock_guard< std::mutex > guard{ r.m_lock };
+                    r.m_live.push_back( this );
+                }
+
+                ~Local()
+                {
+                    auto & r = registry();
+                    std::lock_guard< std::mutex > guard{ r.m_lock };
+                    for ( std::size_t op{0}; op < N_OPS; ++op )
+                        r.m_retired[op].merge( m_ops[op] );
+                    r.m_live.erase( std::find( r.m_live.begin(), r.m_live.end(), this ) );
+                }
+            };
+
+            /// The threads' histograms.
+            struct Registry {
+                std::mutex m_lock;
+                std::vector< Local * > m_live; //!< Histograms of the running threads.
+                snapshot_type m_retired; //!< Merged histograms of the threads that ended.
+            };
+
+            static Registry & registry()
+            {
+                static Registry r;
+                return r;
+            }
+    };
+
+    /*!
+     * @class OpTimer
+     * @brief Times a scope and records its duration as one HashTbl operation.
+     */
+    class OpTimer {
+        public:
+            explicit OpTimer( HashTblOp op_ ) : m_op{ op_ }, m_start{ std::chrono::steady_clock::now() } {}
+
+            ~OpTimer()
+            {
+                auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - m_start );
+                HashTblStats::record( m_op, static_cast< std::uint64_t >( ns.count() ) );
+            }
+
+            OpTimer( const OpTimer & ) = delete;
+            OpTimer& operator=( const OpTimer & ) = delete;
+
+        private:
+            HashTblOp m_op; //!< The operation being timed.
+            std::chrono::steady_clock::time_point m_start; //!< When the operation started.
+    };
+
+} // namespace ac
+#endif
@@ -0,0 +1,160 @@
+/*!
+ * @brief This file contains the declaration of the PartitionedTbl class.
+ *
+ * PartitionedTbl spreads its entries over several shards (stand-ins for the nodes of a
+ * cluster), placing each key with a consistent hashing ring.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file partitioned_tbl.h
+ */
+
+#ifndef PARTITIONED_TBL_H
+#define PARTITIONED_TBL_H
+
+#include <map>          // map
+#include <memory>       // unique_ptr
+#include <mutex>        // mutex
+#include <shared_mutex> // shared_mutex
+#include <vector>       // vector
+
+#include "hashtbl.h"
+#include "hash_ring.h"
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @class PartitionedTbl
+     * @brief A dictionary partitioned over shards, each holding its own HashTbl.
+     *
+     * @note A key is stored on the shard that owns its (mixed) hash value in a HashRing. When a
+     * shard is added, only the keys that the ring now assigns to it move; when a shard is removed,
+     * only its own keys move to the remaining shards. So a change of N shards moves about 1/N of
+     * the keys, whereas `hash % N` placement would move almost all of them.
+     *
+     * Every shard has its own lock, so threads working on different shards do not wait for each
+     * other. Adding or removing a shard locks the whole table while the keys migrate.
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class PartitionedTbl {
+        public:
+            // Aliases
+            using node_type  = HashRing::node_type; //!< The shard (node) identifier type.
+            using table_type = HashTbl<KeyType,DataType,KeyHash,KeyEqual>; //!< The table of each shard.
+            using size_type  = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Creates a table with no shards.
+             * @param vnodes_ The number of virtual nodes of each shard in the ring.
+             */
+            explicit PartitionedTbl( size_type vnodes_ = 128 ) : m_ring{ vnodes_ } {}
+
+            /*!
+             * @brief Adds a shard, moving to it the keys it now owns.
+             * @param node_ The shard identifier.
+             * @return size_type The number of keys moved (0 if the shard already existed).
+             */
+            size_type add_node( node_type node_ );
+
+            /*!
+             * @brief Removes a shard, moving its keys to the shards that now own them.
+             *
+             * A std::logic_error is thrown when removing the last shard while it still holds keys.
+             *
+             * @param node_ The shard identifier.
+             * @return size_type The number of keys moved (0 if the shard did not exist).
+             */
+            size_type remove_node( node_type node_ );
+
+            /*!
+             * @brief Inserts a new entry or updates the data of an existing one.
+             *
+             * A std::logic_error is thrown if the table has no shards.
+             *
+             * @param key_ The key of the entry.
+             * @param new_data_ The data of the entry.
+             * @return bool True if the key was inserted, False if it was updated.
+             */
+            bool insert( const KeyType & key_, const DataType & new_data_ );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Removes an entry from the table.
+             * @param key_ The key of the entry to be removed.
+             * @return bool True if the entry is removed, False if the key is not found.
+             */
+            bool erase( const KeyType & key_ );
+
+            /*!
+             * @brief Finds the shard that owns a key.
+             *
+             * A std::logic_error is thrown if the table has no shards.
+             *
+             * @param key_ The key.
+             * @return node_type The shard identifier.
+             */
+            node_type node_of( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Returns the identifiers of the shards, in increasing order.
+             * @return std::vector<node_type> The shard identifiers.
+             */
+            std::vector< node_type > nodes() const;
+
+            /*!
+             * @brief Returns the number of entries stored on a shard.
+             * @param node_ The shard identifier.
+             * @return size_type The number of entries (0 for unknown shards).
+             */
+            size_type node_size( node_type node_ ) const;
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            size_type size() const;
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            bool empty() const { return size() == 0; }
+
+        private:
+            /// A shard: a table and the lock that guards it.
+            struct Shard {
+                table_type m_table;
+                mutable std::mutex m_lock;
+            };
+
+            /*!
+             * @brief Finds the shard that owns a key (the caller holds m_topology).
+             * @param key_ The key.
+             * @return Shard& The shard.
+             */
+            Shard & shard_of( const KeyType & key_ ) const;
+
+        private:
+            HashRing m_ring; //!< Placement of the keys.
+            std::map< node_type, std::unique_ptr< Shard > > m_shards; //!< The shards, by identifier.
+            mutable std::shared_mutex m_topology; //!< Shared by the operations, exclusive while shards change.
+    };
+
+} // namespace ac
+#include "partitioned_tbl.inl"
+#endif
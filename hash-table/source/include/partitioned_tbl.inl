@@ -0,0 +1,166 @@
+#include "partitioned_tbl.h"
+
+#include <stdexcept> // logic_error
+#include <utility>   // pair
+
+namespace ac
+{
+    /// Add node.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::add_node(node_type node_)
+    {
+        std::unique_lock<std::shared_mutex> guard{m_topology};
+        if (!m_ring.add(node_))
+            return 0;
+
+        auto &target = m_shards[node_];
+        target = std::make_unique<Shard>();
+
+        // only the keys now owned by the new shard leave their old shards
+        KeyHash hash;
+        size_type moved{0};
+        std::vector<std::pair<KeyType, DataType>> leaving;
+        for (auto &[id, shard] : m_shards)
+        {
+            if (id == node_)
+                continue;
+
+            leaving.clear();
+            shard->m_table.for_each([&](const auto &entry) {
+                if (m_ring.node_of(mix64(hash(entry.m_key))) == node_)
+                    leaving.emplace_back(entry.m_key, entry.m_data);
+            });
+            for (const auto &[key, data] : leaving)
+            {
+                target->m_table.insert(key, data);
+                shard->m_table.erase(key);
+            }
+            moved += leaving.size();
+        }
+
+        return moved;
+    }
+
+    /// Remove node.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::remove_node(node_type node_)
+    {
+        std::unique_lock<std::shared_mutex> guard{m_topology};
+        auto it = m_shards.find(node_);
+        if (it == m_shards.end())
+            return 0;
+        if (m_shards.size() == 1 && !it->second->m_table.empty())
+            throw std::logic_error("PartitionedTbl: cannot remove the last shard while it holds keys");
+
+        m_ring.remove(node_);
+
+        // each key of the removed shard goes to the shard that follows it in the ring
+        KeyHash hash;
+        size_type moved = it->second->m_table.size();
+        it->second->m_table.for_each([&](const auto &entry) {
+            m_shards.at(m_ring.node_of(mix64(hash(entry.m_key))))->m_table.insert(entry.m_key, entry.m_data);
+        });
+        m_shards.erase(it);
+
+        return moved;
+    }
+
+    /// Insert.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        Shard &shard = shard_of(key_);
+        std::lock_guard<std::mutex> lock{shard.m_lock};
+        return shard.m_table.insert(key_, new_data_);
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        if (m_shards.empty())
+            return false;
+
+        Shard &shard = shard_of(key_);
+        std::lock_guard<std::mutex> lock{shard.m_lock};
+        return shard.m_table.retrieve(key_, data_item_);
+    }
+
+    /// Erase.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        if (m_shards.empty())
+            return false;
+
+        Shard &shard = shard_of(key_);
+        std::lock_guard<std::mutex> lock{shard.m_lock};
+        return shard.m_table.erase(key_);
+    }
+
+    /// Node of a key.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::node_type
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::node_of(const KeyType &key_) const
+    {
+        KeyHash hash;
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        return m_ring.node_of(mix64(hash(key_)));
+    }
+
+    /// Nodes.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::vector<typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::node_type>
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::nodes() const
+    {
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        std::vector<node_type> ids;
+        for (const auto &entry : m_shards)
+            ids.push_back(entry.first);
+        return ids;
+    }
+
+    /// Node size.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::node_size(node_type node_) const
+    {
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        auto it = m_shards.find(node_);
+        if (it == m_shards.end())
+            return 0;
+
+        std::lock_guard<std::mutex> lock{it->second->m_lock};
+        return it->second->m_table.size();
+    }
+
+    /// Size.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::size() const
+    {
+        std::shared_lock<std::shared_mutex> guard{m_topology};
+        size_type total{0};
+        for (const auto &entry : m_shards)
+        {
+            std::lock_guard<std::mutex> lock{entry.second->m_lock};
+            total += entry.second->m_table.size();
+        }
+        return total;
+    }
+
+    /// Shard of a key.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::Shard &
+    PartitionedTbl<KeyType, DataType, KeyHash, KeyEqual>::shard_of(const KeyType &key_) const
+    {
+        KeyHash hash;
+        return *m_shards.at(m_ring.node_of(mix64(hash(key_))));
+    }
+
+} // namespace ac
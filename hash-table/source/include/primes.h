@@ -0,0 +1,53 @@
+/*!
+ * @brief This file contains the prime number helpers shared by the chained containers.
+ *
+ * The chained tables (`HashTbl`, `HashSet`, `TwoChoiceTbl` and `ShmHashTbl`) keep a prime
+ * number of buckets, so a hash value taken modulo the size uses all of its bits.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file primes.h
+ */
+
+#ifndef PRIMES_H
+#define PRIMES_H
+
+#include <cstddef> // std::size_t
+
+namespace ac
+{
+    /*!
+     * @brief Checks if a number is prime, by trial division by 2, 3 and the numbers 6k - 1 and 6k + 1.
+     * @param n_ The number to check.
+     * @return bool True if the number is prime, false otherwise.
+     */
+    constexpr bool is_prime( std::size_t n_ )
+    {
+        if ( n_ <= 1 )
+            return false;
+        if ( n_ <= 3 )
+            return true;
+        if ( n_ % 2 == 0 || n_ % 3 == 0 )
+            return false;
+        for ( std::size_t i{5}; i * i <= n_; i += 6 )
+        {
+            if ( n_ % i == 0 || n_ % ( i + 2 ) == 0 )
+                return false;
+        }
+        return true;
+    }
+
+    /*!
+     * @brief Finds the next prime number greater than or equal to a given number.
+     * @param n_ The number to find the next prime for.
+     * @return std::size_t The next prime number.
+     */
+    constexpr std::size_t next_prime( std::size_t n_ )
+    {
+        // while n_ is not prime, increment and test again
+        while ( !is_prime( n_ ) )
+            ++n_;
+        return n_;
+    }
+} // namespace ac
+
+#endif
@@ -0,0 +1,242 @@
+/*!
+ * @brief This file contains the declaration of the ShmHashTbl class.
+ *
+ * ShmHashTbl is a hash table with separate chaining that lives in a POSIX shared-memory
+ * segment, so several processes can read and update the very same table without copies.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file shm_hashtbl.h
+ */
+
+#ifndef SHM_HASHTBL_H
+#define SHM_HASHTBL_H
+
+#include <pthread.h>    // pthread_mutex_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <functional>   // hash, equal_to
+#include <stdexcept>    // length_error, runtime_error
+#include <string>       // string
+#include <type_traits>  // is_trivially_copyable
+
+#include "primes.h"
+
+namespace ac
+{
+    /*!
+     * @class ShmHashTbl
+     * @brief A fixed capacity hash table stored in a named POSIX shared-memory segment.
+     *
+     * @note Each process maps the segment at its own address, so the table holds no pointers:
+     * buckets and chains refer to nodes by their index in a node array placed right after
+     * the buckets. Unused nodes form a free list. Every operation runs under a process-shared
+     * robust mutex stored in the segment; if a process dies while holding it, the next process
+     * to lock it takes it over (the updates keep the chains traversable at every step).
+     *
+     * Both KeyType and DataType must be trivially copyable (e.g. `PackedKey` and `float`), and
+     * KeyHash must give the same value for a key in every process (which rules out hashing
+     * addresses or per-process random seeds).
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class ShmHashTbl {
+        static_assert( std::is_trivially_copyable< KeyType >::value, "ShmHashTbl keys must be trivially copyable" );
+        static_assert( std::is_trivially_copyable< DataType >::value, "ShmHashTbl data must be trivially copyable" );
+
+        public:
+            // Aliases
+            using size_type = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Creates a new shared-memory segment holding an empty table.
+             *
+             * A std::runtime_error is thrown if a segment with that name already exists or cannot be created.
+             *
+             * @param name_ The segment name (e.g. "/accounts"), as for shm_open().
+             * @param capacity_ The maximum number of entries in the table.
+             * @return ShmHashTbl The table mapped into this process.
+             */
+            static ShmHashTbl create( const std::string & name_, size_type capacity_ );
+
+            /*!
+             * @brief Maps an existing table, created by this or another process.
+             *
+             * A std::runtime_error is thrown if the segment does not exist or does not hold a table of this type.
+             *
+             * @param name_ The segment name.
+             * @return ShmHashTbl The table mapped into this process.
+             */
+            static ShmHashTbl open( const std::string & name_ );
+
+            /*!
+             * @brief Removes the segment name; the memory is released once every process unmaps it.
+             * @param name_ The segment name.
+             * @return bool True if the name was removed, False if it did not exist.
+             */
+            static bool remove( const std::string & name_ );
+
+            /*!
+             * @brief Move constructor, takes over the mapping of another table object.
+             * @param other The table to be moved.
+             */
+            ShmHashTbl( ShmHashTbl && other ) noexcept;
+
+            /*!
+             * @brief Move assignment operator, takes over the mapping of another table object.
+             * @param other The table to be moved.
+             * @return ShmHashTbl& Reference to the current table.
+             */
+            ShmHashTbl& operator=( ShmHashTbl && other ) noexcept;
+
+            ShmHashTbl( const ShmHashTbl & ) = delete;
+            ShmHashTbl& operator=( const ShmHashTbl & ) = delete;
+
+            /*!
+             * @brief Destructor, unmaps the segment (the table itself survives in the segment).
+             */
+            ~ShmHashTbl();
+
+            /*!
+             * @brief Inserts a new entry or updates the data of an existing one.
+             *
+             * A std::length_error is thrown if the key is new and the table is full.
+             *
+             * @param key_ The key of the entry.
+             * @param new_data_ The data of the entry.
+             * @return bool True if the key was inserted, False if it was updated.
+             */
+            bool insert( const KeyType & key_, const DataType & new_data_ );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Applies a function to the data of a key, with the table locked.
+             *
+             * This makes read-modify-write updates (e.g. a deposit) atomic across processes.
+             *
+             * @param key_ The key of the entry.
+             * @param fn_ A function that takes a `DataType&`.
+             * @return bool True if the key is found, False otherwise.
+             */
+            template< typename Function >
+            bool update( const KeyType & key_, Function fn_ );
+
+            /*!
+             * @brief Removes an entry from the table.
+             * @param key_ The key of the entry to be removed.
+             * @return bool True if the entry is removed, False if the key is not found.
+             */
+            bool erase( const KeyType & key_ );
+
+            /*!
+             * @brief Removes all the entries of the table.
+             */
+            void clear();
+
+            /*!
+             * @brief Calls a function on every entry of the table, with the table locked.
+             * @param fn_ A function that takes `(const KeyType&, const DataType&)`.
+             */
+            template< typename Function >
+            void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            bool empty() const { return size() == 0; }
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            size_type size() const;
+
+            /*!
+             * @brief Returns the maximum number of entries in the table.
+             * @return size_type The capacity.
+             */
+            size_type capacity() const;
+
+        private:
+            /// A node of a collision list.
+            struct Node {
+                KeyType m_key;        //!< The key.
+                DataType m_data;      //!< The data.
+                std::uint64_t m_next; //!< Index + 1 of the next node in the list (0 ends the list).
+            };
+
+            /// The control block, at the start of the segment.
+            struct Header {
+                std::uint32_t m_magic;      //!< Tag written once the table is ready.
+                std::uint32_t m_node_size;  //!< sizeof(Node), to detect a mismatch of types.
+                pthread_mutex_t m_lock;     //!< Process-shared robust mutex.
+                std::uint64_t m_capacity;   //!< Number of nodes.
+                std::uint64_t m_n_buckets;  //!< Number of buckets.
+                std::uint64_t m_count;      //!< Number of entries.
+                std::uint64_t m_free;       //!< Index + 1 of the first free node (0 if full).
+            };
+
+            /// Locks the table for the lifetime of the object.
+            class Guard {
+                public:
+                    explicit Guard( Header * header_ );
+                    ~Guard();
+                    Guard( const Guard & ) = delete;
+                    Guard& operator=( const Guard & ) = delete;
+                private:
+                    Header * m_header;
+            };
+
+            /*!
+             * @brief Wraps a mapped segment.
+             * @param base_ The address of the mapping.
+             * @param bytes_ The length of the mapping.
+             */
+            ShmHashTbl( void * base_, size_type bytes_ ) : m_base{ base_ }, m_bytes{ bytes_ } {}
+
+            Header * header() const { return static_cast< Header * >( m_base ); }
+            std::uint64_t * buckets() const;
+            Node * nodes() const;
+
+            /*!
+             * @brief Finds the link (bucket head or `m_next` field) that refers to the node of a key.
+             * @param key_ The key to search for.
+             * @return std::uint64_t* The link, which holds 0 if the key is not in the table.
+             */
+            std::uint64_t * find_link( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Empties the buckets and chains every node into the free list.
+             */
+            void reset();
+
+            /*!
+             * @brief Computes the length of the segment.
+             * @param capacity_ The number of nodes.
+             * @param n_buckets_ The number of buckets.
+             * @return size_type The length in bytes.
+             */
+            static size_type segment_size( size_type capacity_, size_type n_buckets_ );
+
+        private:
+            void * m_base{ nullptr }; //!< Address of the mapping in this process.
+            size_type m_bytes{ 0 };   //!< Length of the mapping.
+            static constexpr std::uint32_t MAGIC = 0x5a484d53; //!< Tag that identifies a ready table.
+    };
+
+} // namespace ac
+#include "shm_hashtbl.inl"
+#endif
@@ -0,0 +1,328 @@
+#include "shm_hashtbl.h"
+
+#include <fcntl.h>    // O_CREAT, O_EXCL, O_RDWR
+#include <sys/mman.h> // shm_open, mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // ftruncate, close
+
+#include <cerrno>   // errno, EOWNERDEAD
+#include <cstring>  // strerror
+#include <utility>  // swap
+
+namespace ac
+{
+    /// Create.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::create(const std::string &name_, size_type capacity_)
+    {
+        if (capacity_ == 0)
+            throw std::length_error("ShmHashTbl: the capacity must be positive");
+
+        size_type n_buckets = next_prime(capacity_);
+        size_type bytes = segment_size(capacity_, n_buckets);
+
+        // O_EXCL: only one process creates (and initializes) the table
+        int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            throw std::runtime_error("ShmHashTbl: cannot create " + name_ + ": " + std::strerror(errno));
+
+        void *base = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+            base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            shm_unlink(name_.c_str());
+            throw std::runtime_error("ShmHashTbl: cannot map " + name_ + ": " + std::strerror(error));
+        }
+
+        ShmHashTbl table{base, bytes};
+        Header *h = table.header();
+        h->m_node_size = sizeof(Node);
+        h->m_capacity = capacity_;
+        h->m_n_buckets = n_buckets;
+
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&h->m_lock, &attr);
+        pthread_mutexattr_destroy(&attr);
+
+        table.reset();
+
+        // the tag is published last, so other processes never see a half built table
+        __atomic_store_n(&h->m_magic, MAGIC, __ATOMIC_RELEASE);
+        return table;
+    }
+
+    /// Open.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::open(const std::string &name_)
+    {
+        int fd = shm_open(name_.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            throw std::runtime_error("ShmHashTbl: cannot open " + name_ + ": " + std::strerror(errno));
+
+        struct stat st;
+        void *base = MAP_FAILED;
+        size_type bytes = 0;
+        if (fstat(fd, &st) == 0 && static_cast<size_type>(st.st_size) >= sizeof(Header))
+        {
+            bytes = static_cast<size_type>(st.st_size);
+            base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (base == MAP_FAILED)
+            throw std::runtime_error("ShmHashTbl: cannot map " + name_);
+
+        // the destructor unmaps the segment if the checks below fail
+        ShmHashTbl table{base, bytes};
+        const Header *h = table.header();
+        if (__atomic_load_n(&h->m_magic, __ATOMIC_ACQUIRE) != MAGIC || h->m_node_size != sizeof(Node) ||
+            segment_size(h->m_capacity, h->m_n_buckets) != bytes)
+            throw std::runtime_error("ShmHashTbl: " + name_ + " does not hold a table of this type");
+
+        return table;
+    }
+
+    /// Remove.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::remove(const std::string &name_)
+    {
+        return shm_unlink(name_.c_str()) == 0;
+    }
+
+    /// Move constructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::ShmHashTbl(ShmHashTbl &&other) noexcept
+        : m_base{other.m_base}, m_bytes{other.m_bytes}
+    {
+        other.m_base = nullptr;
+        other.m_bytes = 0;
+    }
+
+    /// Move assignment.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual> &
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::operator=(ShmHashTbl &&other) noexcept
+    {
+        // the old mapping is released by the destructor of other
+        std::swap(m_base, other.m_base);
+        std::swap(m_bytes, other.m_bytes);
+        return *this;
+    }
+
+    /// Destructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::~ShmHashTbl()
+    {
+        if (m_base != nullptr)
+            munmap(m_base, m_bytes);
+    }
+
+    /// Guard: locks the table, taking over the lock of a process that died holding it.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Guard::Guard(Header *header_) : m_header{header_}
+    {
+        int rc = pthread_mutex_lock(&m_header->m_lock);
+        if (rc == EOWNERDEAD)
+            pthread_mutex_consistent(&m_header->m_lock);
+        else if (rc != 0)
+            throw std::runtime_error(std::string("ShmHashTbl: cannot lock the table: ") + std::strerror(rc));
+    }
+
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Guard::~Guard()
+    {
+        pthread_mutex_unlock(&m_header->m_lock);
+    }
+
+    /// Insert.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        KeyHash hash;
+        Guard guard{header()};
+        Header *h = header();
+
+        std::uint64_t *link = find_link(key_);
+        if (*link != 0)
+        {
+            nodes()[*link - 1].m_data = new_data_;
+            return false;
+        }
+
+        if (h->m_free == 0)
+            throw std::length_error("ShmHashTbl: the table is full");
+
+        // takes a node from the free list, fills it, then links it at the head of its bucket
+        std::uint64_t id = h->m_free;
+        Node &node = nodes()[id - 1];
+        h->m_free = node.m_next;
+        std::uint64_t &head = buckets()[hash(key_) % h->m_n_buckets];
+        node.m_key = key_;
+        node.m_data = new_data_;
+        node.m_next = head;
+        head = id;
+        ++h->m_count;
+        return true;
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        Guard guard{header()};
+        std::uint64_t *link = find_link(key_);
+        if (*link == 0)
+            return false;
+
+        data_item_ = nodes()[*link - 1].m_data;
+        return true;
+    }
+
+    /// Update.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    bool ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::update(const KeyType &key_, Function fn_)
+    {
+        Guard guard{header()};
+        std::uint64_t *link = find_link(key_);
+        if (*link == 0)
+            return false;
+
+        fn_(nodes()[*link - 1].m_data);
+        return true;
+    }
+
+    /// Erase.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        Guard guard{header()};
+        Header *h = header();
+
+        std::uint64_t *link = find_link(key_);
+        if (*link == 0)
+            return false;
+
+        // unlinks the node from its list, then returns it to the free list
+        std::uint64_t id = *link;
+        Node &node = nodes()[id - 1];
+        *link = node.m_next;
+        node.m_next = h->m_free;
+        h->m_free = id;
+        --h->m_count;
+        return true;
+    }
+
+    /// Clear.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        Guard guard{header()};
+        reset();
+    }
+
+    /// For each.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    void ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        Guard guard{header()};
+        const Header *h = header();
+        for (std::uint64_t b{0}; b < h->m_n_buckets; ++b)
+        {
+            for (std::uint64_t id = buckets()[b]; id != 0; id = nodes()[id - 1].m_next)
+            {
+                const Node &node = nodes()[id - 1];
+                fn_(node.m_key, node.m_data);
+            }
+        }
+    }
+
+    /// Size.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size() const
+    {
+        Guard guard{header()};
+        return header()->m_count;
+    }
+
+    /// Capacity.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::capacity() const
+    {
+        // fixed at creation, so no lock is needed
+        return header()->m_capacity;
+    }
+
+    /// Buckets: right after the header.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint64_t *ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::buckets() const
+    {
+        constexpr size_type offset = (sizeof(Header) + alignof(std::uint64_t) - 1) / alignof(std::uint64_t) * alignof(std::uint64_t);
+        return reinterpret_cast<std::uint64_t *>(static_cast<char *>(m_base) + offset);
+    }
+
+    /// Nodes: right after the buckets.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::Node *
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::nodes() const
+    {
+        auto end_of_buckets = reinterpret_cast<char *>(buckets() + header()->m_n_buckets) - static_cast<char *>(m_base);
+        size_type offset = (end_of_buckets + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+        return reinterpret_cast<Node *>(static_cast<char *>(m_base) + offset);
+    }
+
+    /// Find link.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    std::uint64_t *ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::find_link(const KeyType &key_) const
+    {
+        KeyHash hash;
+        KeyEqual equal;
+
+        Node *pool = nodes();
+        std::uint64_t *link = &buckets()[hash(key_) % header()->m_n_buckets];
+        while (*link != 0 && !equal(pool[*link - 1].m_key, key_))
+            link = &pool[*link - 1].m_next;
+
+        return link;
+    }
+
+    /// Reset.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::reset()
+    {
+        Header *h = header();
+        std::uint64_t *heads = buckets();
+        for (std::uint64_t b{0}; b < h->m_n_buckets; ++b)
+            heads[b] = 0;
+
+        // node i is followed by node i + 1 in the free list
+        Node *pool = nodes();
+        for (std::uint64_t i{0}; i < h->m_capacity; ++i)
+            pool[i].m_next = (i + 1 < h->m_capacity) ? i + 2 : 0;
+
+        h->m_free = 1;
+        h->m_count = 0;
+    }
+
+    /// Segment size.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    ShmHashTbl<KeyType, DataType, KeyHash, KeyEqual>::segment_size(size_type capacity_, size_type n_buckets_)
+    {
+        size_type bytes = (sizeof(Header) + alignof(std::uint64_t) - 1) / alignof(std::uint64_t) * alignof(std::uint64_t);
+        bytes += n_buckets_ * sizeof(std::uint64_t);
+        bytes = (bytes + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+        return bytes + capacity_ * sizeof(Node);
+    }
+
+} // namespace ac
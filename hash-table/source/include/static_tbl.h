@@ -0,0 +1,219 @@
+/*!
+ * @brief This file contains the declaration of the StaticTbl class.
+ *
+ * StaticTbl is a fixed capacity hash table whose operations are all constexpr, so tables
+ * known at compile time (e.g. bank code to bank metadata) are built by the compiler, with no
+ * startup cost and no dynamic allocation.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file static_tbl.h
+ */
+
+#ifndef STATIC_TBL_H
+#define STATIC_TBL_H
+
+#include <array>            // array
+#include <cstdint>          // std::uint64_t
+#include <functional>       // equal_to
+#include <initializer_list> // initializer_list
+#include <stdexcept>        // length_error, out_of_range
+#include <string_view>      // string_view
+#include <type_traits>      // enable_if, is_integral, is_enum
+
+#include "hash_mix.h"
+
+namespace ac
+{
+    /*!
+     * @struct ConstHash
+     * @brief Hash functor that can run at compile time, for integral and enum types and std::string_view.
+     */
+    template< class KeyType, class Enable = void >
+    struct ConstHash;
+
+    template< class KeyType >
+    struct ConstHash< KeyType, std::enable_if_t< std::is_integral< KeyType >::value || std::is_enum< KeyType >::value > > {
+        constexpr std::uint64_t operator()( KeyType key_ ) const
+        {
+            return mix64( static_cast< std::uint64_t >( key_ ) );
+        }
+    };
+
+    template<>
+    struct ConstHash< std::string_view > {
+        /// FNV-1a.
+        constexpr std::uint64_t operator()( std::string_view key_ ) const
+        {
+            std::uint64_t h = 0xcbf29ce484222325ULL;
+            for ( char c : key_ )
+            {
+                h ^= static_cast< unsigned char >( c );
+                h *= 0x100000001b3ULL;
+            }
+            return h;
+        }
+    };
+
+    /*!
+     * @struct StaticEntry
+     * @brief A key and its data, as given to the StaticTbl constructor.
+     */
+    template< class KeyType, class DataType >
+    struct StaticEntry {
+        KeyType m_key;   //!< The key.
+        DataType m_data; //!< The data.
+    };
+
+    /*!
+     * @class StaticTbl
+     * @brief A constexpr hash table with open addressing, for up to `Capacity` entries.
+     *
+     * @note The entries are kept in an std::array of slots (a power of two, at least twice the
+     * capacity) and found by linear probing; erase shifts the following entries back, so no
+     * tombstones are needed. KeyType and DataType must be literal types with a default
+     * constructor, and KeyHash and KeyEqual must be constexpr functors (e.g. ConstHash).
+     *
+     * Operations that fail at compile time (inserting into a full table, calling at() with an
+     * unknown key) are compile errors.
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam Capacity The maximum number of entries.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              std::size_t Capacity,
+              class KeyHash = ConstHash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class StaticTbl {
+        public:
+            // Aliases
+            using entry_type = StaticEntry< KeyType, DataType >; //!< The type of individual entries in the table.
+            using size_type  = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Default constructor, creates an empty table.
+             */
+            constexpr StaticTbl() = default;
+
+            /*!
+             * @brief Creates a table with the entries of a list (later entries win on repeated keys).
+             *
+             * A std::length_error is thrown if the list has more than Capacity distinct keys.
+             *
+             * @param ilist The list of entries.
+             */
+            constexpr StaticTbl( std::initializer_list< entry_type > ilist );
+
+            /*!
+             * @brief Inserts a new entry or updates the data of an existing one.
+             *
+             * A std::length_error is thrown if the key is new and the table is full.
+             *
+             * @param key_ The key of the entry.
+             * @param new_data_ The data of the entry.
+             * @return bool True if the key was inserted, False if it was updated.
+             */
+            constexpr bool insert( const KeyType & key_, const DataType & new_data_ );
+
+            /*!
+             * @brief Removes an entry from the table.
+             * @param key_ The key of the entry to be removed.
+             * @return bool True if the entry is removed, False if the key is not found.
+             */
+            constexpr bool erase( const KeyType & key_ );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            constexpr bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Accesses the data associated with a given key.
+             *
+             * If the key is not found, an out of range exception is thrown.
+             *
+             * @param key_ The key of the item to be accessed.
+             * @return const DataType& Reference to the data associated with the key.
+             */
+            constexpr const DataType& at( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Returns the number of entries with a given key.
+             * @param key_ The key.
+             * @return size_type 1 if the key is in the table, 0 otherwise.
+             */
+            constexpr size_type count( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Calls a function on every entry of the table.
+             * @param fn_ A function that takes a `const entry_type&`.
+             */
+            template< typename Function >
+            constexpr void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            constexpr bool empty() const { return m_count == 0; }
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            constexpr size_type size() const { return m_count; }
+
+            /*!
+             * @brief Returns the maximum number of entries in the table.
+             * @return size_type The capacity.
+             */
+            static constexpr size_type capacity() { return Capacity; }
+
+        private:
+            /// A slot of the table.
+            struct Slot {
+                entry_type m_entry{}; //!< The entry.
+                bool m_used{ false }; //!< Whether the slot holds an entry.
+            };
+
+            /*!
+             * @brief Computes the number of slots: the smallest power of two at least twice the capacity.
+             * @return size_type The number of slots.
+             */
+            static constexpr size_type slot_count()
+            {
+                size_type n{ 1 };
+                while ( n < 2 * Capacity )
+                    n <<= 1;
+                return n;
+            }
+
+            /*!
+             * @brief Finds the slot holding a key, or the empty slot where it would be inserted.
+             * @param key_ The key.
+             * @return size_type The slot index.
+             */
+            constexpr size_type find_slot( const KeyType & key_ ) const;
+
+            /*!
+             * @brief Finds the preferred slot of a key.
+             * @param key_ The key.
+             * @return size_type The slot index.
+             */
+            static constexpr size_type home_of( const KeyType & key_ );
+
+        private:
+            static constexpr size_type SLOTS = slot_count(); //!< Number of slots.
+            std::array< Slot, SLOTS > m_slots{}; //!< The slots.
+            size_type m_count{ 0 }; //!< Number of entries.
+    };
+
+} // namespace ac
+#include "static_tbl.inl"
+#endif
@@ -0,0 +1,126 @@
+#include "static_tbl.h"
+
+namespace ac
+{
+    /// Initializer constructor.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::StaticTbl(std::initializer_list<entry_type> ilist)
+    {
+        for (const auto &entry : ilist)
+            insert(entry.m_key, entry.m_data);
+    }
+
+    /// Insert.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr bool StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        size_type pos = find_slot(key_);
+        if (m_slots[pos].m_used)
+        {
+            m_slots[pos].m_entry.m_data = new_data_;
+            return false;
+        }
+
+        if (m_count == Capacity)
+            throw std::length_error("StaticTbl: the table is full");
+
+        m_slots[pos].m_entry.m_key = key_;
+        m_slots[pos].m_entry.m_data = new_data_;
+        m_slots[pos].m_used = true;
+        ++m_count;
+        return true;
+    }
+
+    /// Erase.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr bool StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        size_type hole = find_slot(key_);
+        if (!m_slots[hole].m_used)
+            return false;
+
+        // backward shift: moves back each following entry that may live in the hole
+        size_type next = (hole + 1) & (SLOTS - 1);
+        while (m_slots[next].m_used)
+        {
+            size_type home = home_of(m_slots[next].m_entry.m_key);
+            // distance from the home of the entry to the hole, and to the entry itself
+            if (((hole - home) & (SLOTS - 1)) < ((next - home) & (SLOTS - 1)))
+            {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+            next = (next + 1) & (SLOTS - 1);
+        }
+
+        m_slots[hole] = Slot{};
+        --m_count;
+        return true;
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr bool StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const Slot &slot = m_slots[find_slot(key_)];
+        if (!slot.m_used)
+            return false;
+
+        data_item_ = slot.m_entry.m_data;
+        return true;
+    }
+
+    /// At.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr const DataType &StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::at(const KeyType &key_) const
+    {
+        const Slot &slot = m_slots[find_slot(key_)];
+        if (!slot.m_used)
+            throw std::out_of_range("Key not found");
+
+        return slot.m_entry.m_data;
+    }
+
+    /// Count.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr typename StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::size_type
+    StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::count(const KeyType &key_) const
+    {
+        return m_slots[find_slot(key_)].m_used ? 1 : 0;
+    }
+
+    /// For each.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    constexpr void StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        for (const auto &slot : m_slots)
+            if (slot.m_used)
+                fn_(slot.m_entry);
+    }
+
+    /// Find slot.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr typename StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::size_type
+    StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::find_slot(const KeyType &key_) const
+    {
+        KeyEqual equal{};
+
+        // at most half of the slots are used, so the probe always meets an empty slot
+        size_type pos = home_of(key_);
+        while (m_slots[pos].m_used && !equal(m_slots[pos].m_entry.m_key, key_))
+            pos = (pos + 1) & (SLOTS - 1);
+
+        return pos;
+    }
+
+    /// Home of a key.
+    template <typename KeyType, typename DataType, std::size_t Capacity, typename KeyHash, typename KeyEqual>
+    constexpr typename StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::size_type
+    StaticTbl<KeyType, DataType, Capacity, KeyHash, KeyEqual>::home_of(const KeyType &key_)
+    {
+        KeyHash hash{};
+        return static_cast<size_type>(hash(key_)) & (SLOTS - 1);
+    }
+
+} // namespace ac
@@ -0,0 +1,128 @@
+/*!
+ * @brief This file contains the declaration and implementation of the StripedCounter class.
+ *
+ * StripedCounter is a number that many threads may add to at once without contending on a
+ * single cache line: each thread adds to its own slot, and readers sum the slots.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file striped_counter.h
+ */
+
+#ifndef STRIPED_COUNTER_H
+#define STRIPED_COUNTER_H
+
+#include <atomic>      // atomic
+#include <cstddef>     // std::size_t
+#include <memory>      // unique_ptr
+#include <thread>      // thread::hardware_concurrency
+#include <type_traits> // is_arithmetic, is_integral
+
+namespace ac
+{
+    /*!
+     * @class StripedCounter
+     * @brief A counter split into cache-line sized slots, one per thread.
+     *
+     * @note Threads are assigned slots round-robin on their first add() to any counter, so up to
+     * slots() threads never share a slot (nor a cache line). add() touches only the caller's
+     * slot; load() sums all the slots, and drain() takes the sum out (leaving zero), which is how
+     * the pending increments are folded into the value they belong to. Values added while
+     * another thread drains are never lost: they are either in the returned sum or left behind.
+     *
+     * @tparam T The arithmetic type of the counter.
+     */
+    template< typename T >
+    class StripedCounter {
+        static_assert( std::is_arithmetic< T >::value, "StripedCounter needs an arithmetic type" );
+
+        public:
+            // Aliases
+            using value_type = T; //!< The type of the counter.
+            using size_type = std::size_t; //!< The size type.
+
+            static constexpr size_type CACHE_LINE = 64; //!< Bytes per slot.
+
+            /*!
+             * @brief Creates a zero counter.
+             * @param slots_ The number of slots (rounded up to a power of two); by default, one per hardware thread.
+             */
+            explicit StripedCounter( size_type slots_ = std::thread::hardware_concurrency() )
+            {
+                m_mask = 1;
+                while ( m_mask < slots_ )
+                    m_mask <<= 1;
+                m_slots.reset( new Slot[ m_mask ] );
+                --m_mask;
+            }
+
+            StripedCounter( const StripedCounter & ) = delete;
+            StripedCounter& operator=( const StripedCounter & ) = delete;
+
+            /*!
+             * @brief Adds to the slot of the calling thread.
+             * @param delta_ The value to add (may be negative).
+             */
+            void add( T delta_ )
+            {
+                std::atomic< T > & slot = m_slots[ thread_index() & m_mask ].m_value;
+                if constexpr ( std::is_integral< T >::value )
+                    slot.fetch_add( delta_, std::memory_order_relaxed );
+                else
+                {
+                    // no fetch_add for floating point before C++20; the slot is rarely shared, so the loop rarely retries
+                    T old = slot.load( std::memory_order_relaxed );
+                    while ( not slot.compare_exchange_weak( old, old + delta_, std::memory_order_relaxed ) )
+                        ;
+                }
+            }
+
+            /*!
+             * @brief Sums the slots.
+             * @return T The value of the counter (not a snapshot, if other threads are adding).
+             */
+            T load() const
+            {
+                T total{0};
+                for ( size_type i{0}; i <= m_mask; ++i )
+                    total += m_slots[i].m_value.load( std::memory_order_relaxed );
+                return total;
+            }
+
+            /*!
+             * @brief Takes the value out of the counter, leaving zero.
+             * @return T The value removed.
+             */
+            T drain()
+            {
+                T total{0};
+                for ( size_type i{0}; i <= m_mask; ++i )
+                    total += m_slots[i].m_value.exchange( T{0}, std::memory_order_relaxed );
+                return total;
+            }
+
+            /*!
+             * @brief Returns the number of slots.
+             * @return size_type The number of slots.
+             */
+            size_type slots() const { return m_mask + 1; }
+
+        private:
+            /// A slot, alone in its cache line.
+            struct alignas( CACHE_LINE ) Slot {
+                std::atomic< T > m_value{ T{0} };
+            };
+
+            /// Index of the calling thread, assigned round-robin on first use.
+            static size_type thread_index()
+            {
+                static std::atomic< size_type > next{ 0 };
+                thread_local size_type index = next.fetch_add( 1, std::memory_order_relaxed );
+                return index;
+            }
+
+            std::unique_ptr< Slot[] > m_slots; //!< The slots.
+            size_type m_mask{ 0 }; //!< Number of slots - 1.
+    };
+
+} // namespace ac
+#endif
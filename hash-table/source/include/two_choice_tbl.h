@@ -0,0 +1,189 @@
+/*!
+ * @brief This file contains the declaration of the TwoChoiceTbl class.
+ *
+ * TwoChoiceTbl is a hash table with separate chaining in which every key may live in either
+ * of two buckets, which keeps the longest chain very short.
+ *
+ * @author Tobias dos Santos Neto, Wisla Alves Argolo
+ * @file two_choice_tbl.h
+ */
+
+#ifndef TWO_CHOICE_TBL_H
+#define TWO_CHOICE_TBL_H
+
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <forward_list> // forward_list
+#include <functional>   // hash, equal_to
+#include <stdexcept>    // out_of_range
+#include <vector>       // vector
+
+#include "hashtbl.h"
+#include "hash_mix.h"
+#include "primes.h"
+
+namespace ac
+{
+    /*!
+     * @class TwoChoiceTbl
+     * @brief A hash table with "power of two choices" placement.
+     *
+     * @note Each key gets two candidate buckets, from two independent hashes. A new key goes to
+     * the shorter of the two chains, and lookups search both (the first nodes of both chains are
+     * prefetched together). With n keys in n buckets the longest chain grows as O(log log n),
+     * instead of O(log n / log log n) with a single hash.
+     *
+     * When KeyHash has a seeded overload (see has_seeded_hash) the two hashes are two seeded
+     * calls. Otherwise both are derived from one KeyHash value, so keys with equal hash values
+     * share both buckets and the two choices do not help them.
+     *
+     * @tparam KeyType The key type.
+     * @tparam DataType The data type.
+     * @tparam KeyHash The hash function.
+     * @tparam KeyEqual The key comparison function.
+     */
+    template< class KeyType,
+              class DataType,
+              class KeyHash = std::hash< KeyType >,
+              class KeyEqual = std::equal_to< KeyType > >
+    class TwoChoiceTbl {
+        public:
+            // Aliases
+            using entry_type = HashEntry<KeyType,DataType>; //!< The type of individual entries in the table.
+            using list_type  = std::forward_list< entry_type >; //!< The type of lists used to store entries.
+            using size_type  = std::size_t; //!< The size type.
+
+            /*!
+             * @brief Default constructor.
+             * @param table_sz_ The initial number of buckets (rounded up to a prime).
+             */
+            explicit TwoChoiceTbl( size_type table_sz_ = DEFAULT_SIZE );
+
+            /*!
+             * @brief Inserts a new entry or updates the data of an existing one.
+             * @param key_ The key of the entry.
+             * @param new_data_ The data of the entry.
+             * @return bool True if the key was inserted, False if it was updated.
+             */
+            bool insert( const KeyType & key_, const DataType & new_data_ );
+
+            /*!
+             * @brief Retrieves the data associated with a given key.
+             * @param key_ The key to search for.
+             * @param data_item_ The variable to store the retrieved data.
+             * @return bool True if the key is found, False otherwise.
+             */
+            bool retrieve( const KeyType & key_, DataType & data_item_ ) const;
+
+            /*!
+             * @brief Removes an entry from the table.
+             * @param key_ The key of the entry to be removed.
+             * @return bool True if the entry is removed, False if the key is not found.
+             */
+            bool erase( const KeyType & key_ );
+
+            /*!
+             * @brief Accesses the data associated with a given key.
+             *
+             * If the key is not found, an out of range exception is thrown.
+             *
+             * @param key_ The key of the item to be accessed.
+             * @return DataType& Reference to the data associated with the key.
+             */
+            DataType& at( const KeyType & key_ );
+
+            /*!
+             * @brief Accesses the data associated with a given key, inserting default data if the key is not found.
+             * @param key_ The key of the item to be accessed.
+             * @return DataType& Reference to the data associated with the key.
+             */
+            DataType& operator[]( const KeyType & key_ );
+
+            /*!
+             * @brief Removes all the entries of the table.
+             */
+            void clear();
+
+            /*!
+             * @brief Applies a function to every entry stored in the table.
+             * @param fn_ A function object callable with `const entry_type &`.
+             */
+            template< typename Function >
+            void for_each( Function fn_ ) const;
+
+            /*!
+             * @brief Checks if the table is empty.
+             * @return bool True if the table is empty, False otherwise.
+             */
+            bool empty() const { return m_count == 0; }
+
+            /*!
+             * @brief Returns the number of entries in the table.
+             * @return size_type The number of entries.
+             */
+            size_type size() const { return m_count; }
+
+            /*!
+             * @brief Returns the number of buckets.
+             * @return size_type The number of buckets.
+             */
+            size_type bucket_count() const { return m_table.size(); }
+
+            /*!
+             * @brief Returns the length of the longest chain.
+             * @return size_type The longest chain length.
+             */
+            size_type max_chain_length() const;
+
+            /*!
+             * @brief Returns the maximum load factor of the table.
+             * @return float The maximum load factor.
+             */
+            float max_load_factor() const { return m_max_load_factor; }
+
+            /*!
+             * @brief Sets the maximum load factor of the table.
+             * @param mlf The new maximum load factor.
+             */
+            void max_load_factor( float mlf ) { m_max_load_factor = mlf; }
+
+        private:
+            /// The two candidate buckets of a key.
+            struct Choices {
+                size_type m_first;
+                size_type m_second;
+            };
+
+            /*!
+             * @brief Computes the two candidate buckets of a key.
+             * @param key_ The key.
+             * @param n_buckets_ The number of buckets.
+             * @return Choices The candidate buckets.
+             */
+            static Choices choices_of( const KeyType & key_, size_type n_buckets_ );
+
+            /*!
+             * @brief Finds the entry of a key in its two candidate buckets.
+             * @param key_ The key.
+             * @param c_ The candidate buckets of the key.
+             * @return entry_type* The entry, or nullptr if the key is not in the table.
+             */
+            entry_type * find( const KeyType & key_, const Choices & c_ ) const;
+
+            /*!
+             * @brief Grows the table to about twice its number of buckets, placing every entry again.
+             */
+            void rehash();
+
+        private:
+            std::vector< list_type > m_table; //!< The buckets.
+            std::vector< std::uint32_t > m_lengths; //!< The length of each chain.
+            size_type m_count{ 0 }; //!< Number of entries.
+            float m_max_load_factor{ 1.0 }; //!< The maximum load factor value.
+            static const short DEFAULT_SIZE = 11;
+            static constexpr std::uint64_t FIRST_SEED = 0x2545f4914f6cdd1dULL; //!< Seed of the first seeded hash.
+            static constexpr std::uint64_t SECOND_SEED = 0x9e3779b97f4a7c15ULL; //!< Seed of the second hash.
+    };
+
+} // namespace ac
+#include "two_choice_tbl.inl"
+#endif
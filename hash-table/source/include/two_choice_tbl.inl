@@ -0,0 +1,208 @@
+#include "two_choice_tbl.h"
+
+#include <algorithm> // max_element
+
+namespace ac
+{
+    /// Constructor.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::TwoChoiceTbl(size_type table_sz_)
+    {
+        size_type n = next_prime(table_sz_ < 2 ? 2 : table_sz_);
+        m_table.resize(n);
+        m_lengths.assign(n, 0);
+    }
+
+    /// Insert.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::insert(const KeyType &key_, const DataType &new_data_)
+    {
+        Choices c = choices_of(key_, m_table.size());
+        if (entry_type *entry = find(key_, c))
+        {
+            entry->m_data = new_data_;
+            return false;
+        }
+
+        // the new entry goes to the shorter of its two chains
+        size_type pos = m_lengths[c.m_second] < m_lengths[c.m_first] ? c.m_second : c.m_first;
+        m_table[pos].push_front(entry_type(key_, new_data_));
+        ++m_lengths[pos];
+        ++m_count;
+
+        if (m_count > m_table.size() * m_max_load_factor)
+            rehash();
+
+        return true;
+    }
+
+    /// Retrieve.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::retrieve(const KeyType &key_, DataType &data_item_) const
+    {
+        const entry_type *entry = find(key_, choices_of(key_, m_table.size()));
+        if (entry == nullptr)
+            return false;
+
+        data_item_ = entry->m_data;
+        return true;
+    }
+
+    /// Erase.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    bool TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::erase(const KeyType &key_)
+    {
+        KeyEqual equal;
+        Choices c = choices_of(key_, m_table.size());
+
+        for (size_type pos : {c.m_first, c.m_second})
+        {
+            auto &list = m_table[pos];
+            for (auto prev = list.before_begin(), it = list.begin(); it != list.end(); prev = it++)
+            {
+                if (equal(it->m_key, key_))
+                {
+                    list.erase_after(prev);
+                    --m_lengths[pos];
+                    --m_count;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /// At.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::at(const KeyType &key_)
+    {
+        entry_type *entry = find(key_, choices_of(key_, m_table.size()));
+        if (entry == nullptr)
+            throw std::out_of_range("Key not found");
+
+        return entry->m_data;
+    }
+
+    /// Operator [].
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    DataType &TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::operator[](const KeyType &key_)
+    {
+        if (entry_type *entry = find(key_, choices_of(key_, m_table.size())))
+            return entry->m_data;
+
+        // the nodes are relinked by a rehash, so the new entry keeps its address
+        insert(key_, DataType());
+        return find(key_, choices_of(key_, m_table.size()))->m_data;
+    }
+
+    /// Clear.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::clear()
+    {
+        for (auto &list : m_table)
+            list.clear();
+        std::fill(m_lengths.begin(), m_lengths.end(), 0);
+        m_count = 0;
+    }
+
+    /// For each.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    template <typename Function>
+    void TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::for_each(Function fn_) const
+    {
+        for (const auto &list : m_table)
+            for (const auto &entry : list)
+                fn_(entry);
+    }
+
+    /// Max chain length.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::size_type
+    TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::max_chain_length() const
+    {
+        return *std::max_element(m_lengths.begin(), m_lengths.end());
+    }
+
+    /// Choices of a key.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::Choices
+    TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::choices_of(const KeyType &key_, size_type n_buckets_)
+    {
+        KeyHash hash;
+        std::uint64_t h1, h2;
+        if constexpr (has_seeded_hash<KeyHash, KeyType>::value)
+        {
+            // two truly independent hashes, so keys with equal unseeded hashes still part ways
+            h1 = hash(key_, FIRST_SEED);
+            h2 = hash(key_, SECOND_SEED);
+        }
+        else
+        {
+            // two independent-looking hashes from one call of KeyHash
+            std::uint64_t h = hash(key_);
+            h1 = mix64(h);
+            h2 = mix64(h, SECOND_SEED);
+        }
+
+        // the buckets must differ
+        size_type first = h1 % n_buckets_;
+        size_type second = h2 % (n_buckets_ - 1);
+        if (second >= first)
+            ++second;
+
+        return {first, second};
+    }
+
+    /// Find.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    typename TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::entry_type *
+    TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::find(const KeyType &key_, const Choices &c_) const
+    {
+        KeyEqual equal;
+        auto &first = const_cast<list_type &>(m_table[c_.m_first]);
+        auto &second = const_cast<list_type &>(m_table[c_.m_second]);
+
+#if defined(__GNUC__)
+        // both chains are fetched at once, instead of one after the other
+        if (!first.empty())
+            __builtin_prefetch(&first.front());
+        if (!second.empty())
+            __builtin_prefetch(&second.front());
+#endif
+
+        for (auto &entry : first)
+            if (equal(entry.m_key, key_))
+                return &entry;
+        for (auto &entry : second)
+            if (equal(entry.m_key, key_))
+                return &entry;
+
+        return nullptr;
+    }
+
+    /// Rehash.
+    template <typename KeyType, typename DataType, typename KeyHash, typename KeyEqual>
+    void TwoChoiceTbl<KeyType, DataType, KeyHash, KeyEqual>::rehash()
+    {
+        size_type new_size = next_prime(m_table.size() * 2);
+        std::vector<list_type> aux(new_size);
+        std::vector<std::uint32_t> lengths(new_size, 0);
+
+        // each node is relinked (not copied) into the shorter of its two new chains
+        for (auto &list : m_table)
+        {
+            while (!list.empty())
+            {
+                Choices c = choices_of(list.front().m_key, new_size);
+                size_type pos = lengths[c.m_second] < lengths[c.m_first] ? c.m_second : c.m_first;
+                aux[pos].splice_after(aux[pos].before_begin(), list, list.before_begin());
+                ++lengths[pos];
+            }
+        }
+
+        m_table.swap(aux);
+        m_lengths.swap(lengths);
+    }
+
+} // namespace ac
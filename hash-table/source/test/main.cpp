@@ -2,11 +2,34 @@
 #include <functional>           // std::function
 #include <algorithm>            // std::min_element
 #include <array>
+#include <atomic>
 #include <map>
+#include <sstream>
+#include <thread>
+#include <string>
+#include <vector>
+#include <sys/wait.h>           // waitpid
+#include <unistd.h>             // fork, getpid, _exit
 
 #include "gtest/gtest.h"        // gtest lib
 #include "../include/hashtbl.h"   // header file for tested functions
+#include "../include/frozentbl.h" // read-only table with perfect hashing
+#include "../include/hashset.h"   // table whose keys are projected from the values
+#include "../include/shm_hashtbl.h" // table stored in shared memory
+#include "../include/partitioned_tbl.h" // table partitioned by consistent hashing
+#include "../include/count_min.h"   // approximate key frequencies
+#include "../include/hyperloglog.h" // approximate distinct counts
+#include "../include/static_tbl.h"  // constexpr table
+#include "../include/latency_histogram.h" // latency percentiles
+#include "../include/two_choice_tbl.h" // two-choice bucket placement
+#include "../include/disk_hashtbl.h"    // table stored in a file
+#include "../include/striped_counter.h" // per-thread counter slots
+#include "../include/block_hashtbl.h"   // cache-line bucket blocks
 #include "../driver/account.h"  // To get the account class
+#include "../driver/packed_key.h" // To get the compact account keys
+#include "../driver/account_store.h" // To get the indexed account store
+#include "../driver/account_columns.h" // To get the columnar account store
+#include "../driver/concurrent_accounts.h" // To get the transactional account table
 
 // ============================================================================
 // Test Fxture
@@ -545,6 +568,1101 @@ TEST_F(HTTest, Count)
     //std::cout << "The table: \n" << htable << std::endl;
 }
 
+TEST_F(HTTest, FrozenRetrieve)
+{
+    insert_accounts();
+
+    ac::FrozenTbl< Account::AcctKey, Account, KeyHash, KeyEqual > frozen( ht_accounts );
+    ASSERT_EQ( frozen.size(), ht_accounts.size() );
+
+    // Every account must be found in its slot.
+    for( auto & e : m_accounts )
+    {
+        Account temp;
+        ASSERT_TRUE( frozen.retrieve( e.getKey(), temp ) );
+        ASSERT_EQ( temp, e );
+        ASSERT_EQ( frozen.at( e.getKey() ), e );
+    }
+
+    // Keys that were never inserted must not be found.
+    Account temp;
+    Account missing{ "Nobody", 1, 1668, 11111, 0.f };
+    ASSERT_FALSE( frozen.retrieve( missing.getKey(), temp ) );
+    ASSERT_THROW( frozen.at( missing.getKey() ), std::out_of_range );
+}
+
+TEST_F(HTTest, FrozenSaveLoad)
+{
+    ac::HashTbl<int, int> htable;
+    for( int i{0}; i < 1000; ++i )
+        htable.insert( i*7, i );
+
+    ac::FrozenTbl<int, int> frozen( htable );
+    std::stringstream buffer;
+    frozen.save( buffer );
+    auto loaded = ac::FrozenTbl<int, int>::load( buffer );
+
+    ASSERT_EQ( loaded.size(), htable.size() );
+    for( int i{0}; i < 1000; ++i )
+    {
+        int data;
+        ASSERT_TRUE( loaded.retrieve( i*7, data ) );
+        ASSERT_EQ( data, i );
+        ASSERT_FALSE( loaded.retrieve( i*7+1, data ) );
+    }
+}
+
+TEST_F(HTTest, HashSetInsertRetrieve)
+{
+    ac::HashSet< Account, KeyOfAccount, KeyHash, KeyEqual > accounts{ 4 };
+
+    // Insert each account; the key comes from the account itself.
+    size_t i(0);
+    for( auto & e : m_accounts )
+    {
+        ASSERT_TRUE( accounts.insert( e ) );
+        ASSERT_EQ( ++i, accounts.size() );
+    }
+
+    // Lookups may take views built from the stored keys.
+    for( auto & e : m_accounts )
+    {
+        Account temp;
+        ASSERT_TRUE( accounts.retrieve( e.getKeyView(), temp ) );
+        ASSERT_EQ( temp, e );
+        auto key = e.getKey();
+        ASSERT_EQ( accounts.at( Account::AcctKeyView( key ) ), e );
+    }
+
+    // Inserting an account with an existing key overwrites it.
+    Account richer = m_accounts[2];
+    richer.m_balance = 40000000.f;
+    ASSERT_FALSE( accounts.insert( richer ) );
+    ASSERT_EQ( accounts.size(), m_accounts.size() );
+    ASSERT_EQ( accounts.at( richer.getKeyView() ).m_balance, 40000000.f );
+}
+
+TEST_F(HTTest, HashSetErase)
+{
+    ac::HashSet< Account, KeyOfAccount, KeyHash, KeyEqual > accounts;
+    for( auto & e : m_accounts )
+        accounts.insert( e );
+
+    for( auto & e : m_accounts )
+        ASSERT_TRUE( accounts.erase( e.getKeyView() ) );
+
+    for( auto & e : m_accounts )
+    {
+        Account temp;
+        ASSERT_FALSE( accounts.retrieve( e.getKeyView(), temp ) );
+        ASSERT_FALSE( accounts.erase( e.getKeyView() ) );
+    }
+    ASSERT_TRUE( accounts.empty() );
+}
+
+TEST_F(HTTest, PackedKeys)
+{
+    NamePool pool;
+    ac::HashTbl< PackedKey, float, PackedKeyHash, PackedKeyEqual > balances{ 4 };
+
+    // Store only the balances, under integer keys.
+    for( auto & e : m_accounts )
+        ASSERT_TRUE( balances.insert( pack_key( e, pool ), e.m_balance ) );
+    ASSERT_EQ( pool.size(), m_accounts.size() );
+
+    for( auto & e : m_accounts )
+    {
+        PackedKey key;
+        ASSERT_TRUE( find_key( e.getKey(), pool, key ) );
+        ASSERT_EQ( key.bank_code(), e.m_bank_code );
+        ASSERT_EQ( key.branch_code(), e.m_branch_code );
+        ASSERT_EQ( key.number(), e.m_number );
+        // The account is rebuilt from the key and the stored balance.
+        ASSERT_EQ( unpack_account( key, balances.at( key ), pool ), e );
+    }
+
+    // Unknown names are rejected without growing the pool.
+    PackedKey key;
+    ASSERT_FALSE( find_key( Account{ "Nobody" }.getKey(), pool, key ) );
+    ASSERT_EQ( pool.size(), m_accounts.size() );
+    // Codes that do not fit their fields are rejected.
+    ASSERT_THROW( PackedKey::pack( 0, 70000, 1, 1 ), std::out_of_range );
+    ASSERT_THROW( PackedKey::pack( 0, 1, 1, -1 ), std::out_of_range );
+}
+
+TEST_F(HTTest, ParallelRehash)
+{
+    ac::HashTbl<int, int> htable;
+    // Parallel rehash is opt in.
+    ASSERT_EQ( htable.rehash_threads(), 1u );
+    // Forces several threads, even on a single core machine.
+    htable.rehash_threads( 4 );
+
+    // Enough entries for the last rehashes to run in parallel.
+    const int n{ 300000 };
+    for( int i{0}; i < n; ++i )
+        ASSERT_TRUE( htable.insert( i, 2*i ) );
+    ASSERT_EQ( htable.size(), static_cast<size_t>(n) );
+
+    for( int i{0}; i < n; ++i )
+    {
+        int data;
+        ASSERT_TRUE( htable.retrieve( i, data ) );
+        ASSERT_EQ( data, 2*i );
+    }
+    int data;
+    ASSERT_FALSE( htable.retrieve( n, data ) );
+}
+
+TEST_F(HTTest, AccountStoreIndexes)
+{
+    AccountStore store;
+    for( auto & e : m_accounts )
+        ASSERT_TRUE( store.insert( e ) );
+    ASSERT_EQ( store.size(), m_accounts.size() );
+
+    // Two accounts in bank 1, branch 1668; one in bank 13.
+    ASSERT_EQ( store.by_bank( 1 ).size(), 2 );
+    ASSERT_EQ( store.by_branch( 1, 1668 ).size(), 2 );
+    ASSERT_EQ( store.by_branch( 1, 1 ).size(), 0 );
+    auto bank13 = store.by_bank( 13 );
+    ASSERT_EQ( bank13.size(), 1 );
+    ASSERT_EQ( bank13[0], m_accounts[2] );
+
+    // Balances in [500, 1500]: 530, 850 and 1500, in this order.
+    auto mid = store.by_balance( 500.f, 1500.f );
+    ASSERT_EQ( mid.size(), 3 );
+    ASSERT_EQ( mid[0], m_accounts[1] );
+    ASSERT_EQ( mid[1], m_accounts[3] );
+    ASSERT_EQ( mid[2], m_accounts[0] );
+}
+
+TEST_F(HTTest, AccountStoreSync)
+{
+    AccountStore store;
+    for( auto & e : m_accounts )
+        store.insert( e );
+
+    // Updating a balance moves the account in the balance index.
+    Account acct = m_accounts[0];
+    acct.m_balance = 10.f;
+    ASSERT_TRUE( store.update( acct ) );
+    ASSERT_EQ( store.by_balance( 1500.f, 1500.f ).size(), 0 );
+    auto low = store.by_balance( 0.f, 10.f );
+    ASSERT_EQ( low.size(), 1 );
+    ASSERT_EQ( low[0], acct );
+    // Unknown accounts are not updated.
+    ASSERT_FALSE( store.update( Account{ "Nobody", 1, 1668, 1 } ) );
+    // Non-finite balances are rejected, so the balance index stays ordered.
+    acct.m_balance = std::nanf( "" );
+    ASSERT_FALSE( store.update( acct ) );
+    ASSERT_FALSE( store.insert( Account{ "Nobody", 1, 1668, 1, std::nanf( "" ) } ) );
+    ASSERT_EQ( store.size(), m_accounts.size() );
+    ASSERT_EQ( store.by_balance( 0.f, 10.f ).size(), 1 );
+    acct.m_balance = 10.f;
+
+    // Erasing removes the account from every index.
+    ASSERT_TRUE( store.erase( m_accounts[1].getKey() ) );
+    ASSERT_FALSE( store.erase( m_accounts[1].getKey() ) );
+    ASSERT_EQ( store.by_bank( 1 ).size(), 1 );
+    ASSERT_EQ( store.by_branch( 1, 1668 ).size(), 1 );
+    ASSERT_EQ( store.by_balance( 530.f, 530.f ).size(), 0 );
+
+    ASSERT_TRUE( store.erase( m_accounts[2].getKey() ) );
+    ASSERT_EQ( store.by_bank( 13 ).size(), 0 );
+    ASSERT_EQ( store.by_branch( 13, 1 ).size(), 0 );
+    ASSERT_EQ( store.size(), m_accounts.size() - 2 );
+}
+
+TEST_F(HTTest, AccountColumnsAggregations)
+{
+    AccountColumns columns;
+    for( auto & e : m_accounts )
+        ASSERT_TRUE( columns.insert( e ) );
+
+    double total{ 0 };
+    std::map<int, double> expected;
+    for( auto & e : m_accounts )
+    {
+        total += e.m_balance;
+        expected[e.m_bank_code] += e.m_balance;
+    }
+    ASSERT_DOUBLE_EQ( columns.sum_balance(), total );
+    ASSERT_DOUBLE_EQ( columns.sum_balance( 1 ), 2030. );
+    ASSERT_EQ( columns.min_balance( 1 ), 530.f );
+    ASSERT_EQ( columns.max_balance( 1 ), 1500.f );
+    ASSERT_EQ( columns.sum_balance_by_bank(), expected );
+
+    // Balances 50, 150, 530, 850 fall in [0,1000); 1500, 4850, 5490 in [1000,10000).
+    auto bins = columns.balance_histogram( 0.f, 10000.f, 10 );
+    ASSERT_EQ( bins[0], 4 );
+    ASSERT_EQ( bins[1], 1 );
+    ASSERT_EQ( bins[4], 1 );
+    ASSERT_EQ( bins[5], 1 );
+}
+
+TEST_F(HTTest, AccountColumnsManyRows)
+{
+    // Enough rows for the SIMD kernels and their tails; the balances are integers, so sums are exact.
+    const int N{ 1003 };
+    for( int banks : { 5, 20, 300 } )
+    {
+        AccountColumns columns;
+        std::map<int, double> expected;
+        std::vector<size_t> hist( 16, 0 );
+        for( int i{0}; i < N; ++i )
+        {
+            int bank = 1 + i * 7 % banks;
+            float balance = static_cast<float>( i % 37 * 10 );
+            ASSERT_TRUE( columns.insert( Account( "Client " + std::to_string( i ), bank, 1, i, balance ) ) );
+            expected[bank] += balance;
+            if( balance >= 40.f && balance < 360.f )
+                ++hist[ static_cast<size_t>( ( balance - 40.f ) / 20.f ) ];
+        }
+        ASSERT_EQ( columns.sum_balance_by_bank(), expected );
+        ASSERT_EQ( columns.balance_histogram( 40.f, 360.f, 16 ), hist );
+    }
+}
+
+TEST_F(HTTest, AccountColumnsErase)
+{
+    AccountColumns columns;
+    for( auto & e : m_accounts )
+        columns.insert( e );
+
+    // Erasing the first row moves the last one into its place.
+    ASSERT_TRUE( columns.erase( m_accounts[0].getKey() ) );
+    ASSERT_FALSE( columns.erase( m_accounts[0].getKey() ) );
+    ASSERT_EQ( columns.size(), m_accounts.size() - 1 );
+
+    for( size_t i{1}; i < m_accounts.size(); ++i )
+    {
+        Account temp;
+        ASSERT_TRUE( columns.retrieve( m_accounts[i].getKey(), temp ) );
+        ASSERT_EQ( temp, m_accounts[i] );
+    }
+    ASSERT_DOUBLE_EQ( columns.sum_balance( 1 ), 530. );
+
+    // Rows are found through packed keys: unknown names and codes that cannot be packed miss.
+    Account temp;
+    ASSERT_FALSE( columns.retrieve( std::make_tuple( std::string{ "Nobody" }, 1, 1668, 54321 ), temp ) );
+    ASSERT_FALSE( columns.retrieve( std::make_tuple( m_accounts[1].m_name, 70000, 1668, 45794 ), temp ) );
+    ASSERT_FALSE( columns.erase( std::make_tuple( m_accounts[1].m_name, 1, 1668, -1 ) ) );
+    ASSERT_THROW( columns.insert( Account( "Nobody", 70000, 1, 1, 10.f ) ), std::out_of_range );
+    ASSERT_EQ( columns.size(), m_accounts.size() - 1 );
+}
+
+TEST_F(HTTest, ShmSharedAcrossProcesses)
+{
+    const std::string name{ "/ac_shm_test_" + std::to_string( getpid() ) };
+    using Table = ac::ShmHashTbl< PackedKey, float, PackedKeyHash, PackedKeyEqual >;
+
+    NamePool pool;
+    std::vector< PackedKey > keys;
+    for( auto & e : m_accounts )
+        keys.push_back( pack_key( e, pool ) );
+
+    auto balances = Table::create( name, m_accounts.size() );
+    ASSERT_THROW( Table::create( name, 4 ), std::runtime_error );
+    for( size_t i{0}; i < keys.size(); ++i )
+        ASSERT_TRUE( balances.insert( keys[i], m_accounts[i].m_balance ) );
+    ASSERT_EQ( balances.size(), m_accounts.size() );
+    // The table is full.
+    ASSERT_THROW( balances.insert( PackedKey::pack( 0, 1, 1, 999 ), 0.f ), std::length_error );
+
+    // Another process maps the same table and changes it.
+    pid_t child = fork();
+    if( child == 0 )
+    {
+        auto other = Table::open( name );
+        bool ok = other.update( keys[0], []( float & b ){ b += 100.f; } )
+                  and other.erase( keys[1] )
+                  and not other.erase( keys[1] );
+        _exit( ok ? 0 : 1 );
+    }
+    int status;
+    ASSERT_EQ( waitpid( child, &status, 0 ), child );
+    ASSERT_TRUE( ( WIFEXITED( status ) and WEXITSTATUS( status ) == 0 ) );
+
+    // The changes are seen here, with no copies.
+    float balance;
+    ASSERT_TRUE( balances.retrieve( keys[0], balance ) );
+    ASSERT_EQ( balance, m_accounts[0].m_balance + 100.f );
+    ASSERT_FALSE( balances.retrieve( keys[1], balance ) );
+    ASSERT_EQ( balances.size(), m_accounts.size() - 1 );
+    // The freed node is reused.
+    ASSERT_TRUE( balances.insert( keys[1], 1.f ) );
+
+    size_t visited{ 0 };
+    balances.for_each( [&]( const PackedKey &, const float & ){ ++visited; } );
+    ASSERT_EQ( visited, m_accounts.size() );
+
+    balances.clear();
+    ASSERT_TRUE( balances.empty() );
+
+    ASSERT_TRUE( Table::remove( name ) );
+    ASSERT_FALSE( Table::remove( name ) );
+    ASSERT_THROW( Table::open( name ), std::runtime_error );
+}
+
+TEST_F(HTTest, ShmConcurrentUpdates)
+{
+    const std::string name{ "/ac_shm_test_" + std::to_string( getpid() ) };
+    using Table = ac::ShmHashTbl< int, long >;
+    auto counters = Table::create( name, 16 );
+    for( int k{0}; k < 4; ++k )
+        counters.insert( k, 0 );
+
+    // Several processes increment the same counters at once.
+    const int n_procs{ 4 }, n_incs{ 2000 };
+    std::vector< pid_t > children;
+    for( int p{0}; p < n_procs; ++p )
+    {
+        pid_t child = fork();
+        if( child == 0 )
+        {
+            auto table = Table::open( name );
+            for( int i{0}; i < n_incs; ++i )
+                table.update( i % 4, []( long & c ){ ++c; } );
+            _exit( 0 );
+        }
+        children.push_back( child );
+    }
+    for( auto child : children )
+        waitpid( child, nullptr, 0 );
+
+    // No increment is lost.
+    long total{ 0 };
+    counters.for_each( [&]( const int &, const long & c ){ total += c; } );
+    ASSERT_EQ( total, n_procs * n_incs );
+    ASSERT_TRUE( Table::remove( name ) );
+}
+
+TEST_F(HTTest, PartitionedMigration)
+{
+    ac::PartitionedTbl< int, int > table;
+    ASSERT_THROW( table.insert( 1, 1 ), std::logic_error );
+
+    for( unsigned s{0}; s < 4; ++s )
+        ASSERT_EQ( table.add_node( s ), 0u );
+    ASSERT_EQ( table.add_node( 0 ), 0u );
+
+    const int n{ 20000 };
+    for( int i{0}; i < n; ++i )
+        ASSERT_TRUE( table.insert( i, -i ) );
+    ASSERT_EQ( table.size(), static_cast<size_t>(n) );
+
+    // The virtual nodes spread the keys evenly.
+    for( auto id : table.nodes() )
+    {
+        ASSERT_GT( table.node_size( id ), n / 4 * 0.7 );
+        ASSERT_LT( table.node_size( id ), n / 4 * 1.3 );
+    }
+
+    // A fifth shard takes about 1/5 of the keys, all of them from the other shards.
+    auto moved = table.add_node( 4 );
+    ASSERT_EQ( moved, table.node_size( 4 ) );
+    ASSERT_GT( moved, n / 5 * 0.7 );
+    ASSERT_LT( moved, n / 5 * 1.3 );
+
+    // Removing a shard moves exactly its own keys.
+    auto own = table.node_size( 1 );
+    ASSERT_EQ( table.remove_node( 1 ), own );
+    ASSERT_EQ( table.remove_node( 1 ), 0u );
+    ASSERT_EQ( table.nodes().size(), 4u );
+
+    int value;
+    for( int i{0}; i < n; ++i )
+    {
+        ASSERT_TRUE( table.retrieve( i, value ) );
+        ASSERT_EQ( value, -i );
+        ASSERT_NE( table.node_of( i ), 1u );
+    }
+    ASSERT_EQ( table.size(), static_cast<size_t>(n) );
+
+    for( auto id : { 0u, 2u, 3u } )
+        table.remove_node( id );
+    // The last shard keeps the keys.
+    ASSERT_THROW( table.remove_node( 4 ), std::logic_error );
+    ASSERT_TRUE( table.erase( 0 ) );
+    ASSERT_FALSE( table.retrieve( 0, value ) );
+    ASSERT_EQ( table.size(), static_cast<size_t>(n - 1) );
+}
+
+TEST_F(HTTest, CountMinSketch)
+{
+    // Skewed stream: key k occurs 1000 / (k + 1) times.
+    const int n_keys{ 5000 };
+    std::map< int, unsigned > exact;
+    ac::CountMinSketch< int > even{ 1024, 4 }, odd{ 1024, 4 };
+    for( int k{0}; k < n_keys; ++k )
+    {
+        unsigned times = 1000 / ( k + 1 ) + 1;
+        exact[k] = times;
+        // Two "threads", each with its own sketch.
+        for( unsigned t{0}; t < times; ++t )
+            ( t % 2 == 0 ? even : odd ).add( k );
+    }
+
+    even.merge( odd );
+    auto & sketch = even;
+    ASSERT_EQ( sketch.width(), 1024u );
+    ASSERT_EQ( sketch.memory(), 1024u * 4 * sizeof( uint32_t ) );
+
+    // Never underestimates, and rarely overestimates by more than e / width of the total.
+    int large_errors{ 0 };
+    for( auto & [ key, count ] : exact )
+    {
+        ASSERT_GE( sketch.estimate( key ), count );
+        if( sketch.estimate( key ) - count > 2.72 * sketch.total() / sketch.width() )
+            ++large_errors;
+    }
+    ASSERT_LT( large_errors, n_keys / 50 );
+    // The heaviest keys are nearly exact.
+    ASSERT_LE( sketch.estimate( 0 ), exact[0] + exact[0] / 100 );
+
+    // Conservative update: adding the same key again raises its estimate exactly.
+    auto before = sketch.estimate( 7 );
+    sketch.add( 7, 10 );
+    ASSERT_EQ( sketch.estimate( 7 ), before + 10 );
+
+    ASSERT_THROW( sketch.merge( ac::CountMinSketch< int >{ 512, 4 } ), std::invalid_argument );
+    auto sized = ac::CountMinSketch< int >::with_error( 0.001, 0.01 );
+    ASSERT_GE( sized.width(), 2719u );
+    ASSERT_EQ( sized.depth(), 5u );
+
+    sketch.clear();
+    ASSERT_EQ( sketch.estimate( 0 ), 0u );
+    ASSERT_EQ( sketch.total(), 0u );
+}
+
+TEST_F(HTTest, HyperLogLogDistinct)
+{
+    // Account keys, reusing the KeyHash functor.
+    ac::HyperLogLog< Account::AcctKey, KeyHash > first, second;
+    ASSERT_EQ( first.memory(), 4096u );
+
+    const int n{ 100000 };
+    for( int i{0}; i < n; ++i )
+    {
+        Account acct{ "Client " + std::to_string( i ), 1, 1, i };
+        // Every key is seen twice, by either sketch.
+        first.add( acct.getKey() );
+        ( i % 3 == 0 ? first : second ).add( acct.getKey() );
+    }
+    ASSERT_NEAR( first.estimate(), n, n * 0.05 );
+
+    first.merge( second );
+    ASSERT_NEAR( first.estimate(), n, n * 0.05 );
+
+    // Small counts are (nearly) exact.
+    ac::HyperLogLog< int > small;
+    for( int i{0}; i < 100; ++i )
+        small.add( i % 50 );
+    ASSERT_NEAR( small.estimate(), 50, 2 );
+
+    ASSERT_THROW( small.merge( ac::HyperLogLog< int >{ 10 } ), std::invalid_argument );
+    ASSERT_THROW( ac::HyperLogLog< int >{ 30 }, std::invalid_argument );
+    small.clear();
+    ASSERT_EQ( small.estimate(), 0 );
+}
+
+namespace {
+    /// Bank metadata, known at compile time.
+    struct BankInfo {
+        std::string_view m_name;
+        int m_branches;
+    };
+
+    constexpr ac::StaticTbl< int, BankInfo, 4 > banks{
+        { 1, { "Banco do Brasil", 5000 } },
+        { 33, { "Santander", 2000 } },
+        { 104, { "Caixa", 4000 } },
+        { 341, { "Itau", 3000 } } };
+
+    // Built and queried by the compiler.
+    static_assert( banks.size() == 4 );
+    static_assert( banks.at( 104 ).m_name == "Caixa" );
+    static_assert( banks.count( 237 ) == 0 );
+
+    constexpr auto erased()
+    {
+        ac::StaticTbl< std::string_view, int, 8 > table{ { "one", 1 }, { "two", 2 }, { "three", 3 } };
+        table.erase( "two" );
+        table.insert( "four", 4 );
+        table.insert( "one", 10 );
+        return table;
+    }
+    static_assert( erased().size() == 3 );
+    static_assert( erased().count( "two" ) == 0 );
+    static_assert( erased().at( "one" ) == 10 );
+}
+
+TEST_F(HTTest, StaticTblLookup)
+{
+    BankInfo info{};
+    ASSERT_TRUE( banks.retrieve( 341, info ) );
+    ASSERT_EQ( info.m_name, "Itau" );
+    ASSERT_FALSE( banks.retrieve( 237, info ) );
+    ASSERT_THROW( banks.at( 237 ), std::out_of_range );
+
+    // Many keys landing near each other: erase keeps every other key reachable.
+    ac::StaticTbl< int, int, 64 > table;
+    for( int i{0}; i < 64; ++i )
+        ASSERT_TRUE( table.insert( i * 128, i ) );
+    ASSERT_THROW( table.insert( -1, 0 ), std::length_error );
+    for( int i{0}; i < 64; i += 2 )
+        ASSERT_TRUE( table.erase( i * 128 ) );
+    ASSERT_FALSE( table.erase( 0 ) );
+    for( int i{1}; i < 64; i += 2 )
+        ASSERT_EQ( table.at( i * 128 ), i );
+    ASSERT_EQ( table.size(), 32u );
+
+    int sum{ 0 };
+    table.for_each( [&]( const auto & entry ){ sum += entry.m_data; } );
+    ASSERT_EQ( sum, 32 * 32 );
+}
+
+TEST_F(HTTest, InlineSmallTables)
+{
+    using Table = ac::HashTbl< int, std::string >;
+    ASSERT_EQ( Table::inline_capacity(), 8u );
+
+    Table tiny( 16 );
+    const int n = static_cast<int>( Table::inline_capacity() );
+    for( int i{0}; i < n; ++i )
+        ASSERT_TRUE( tiny.insert( i * 17 + i % 2, std::to_string( i ) ) );
+    ASSERT_TRUE( tiny.is_inline() );
+    ASSERT_FALSE( tiny.insert( 0, "zero" ) );
+    ASSERT_EQ( tiny.at( 0 ), "zero" );
+    ASSERT_EQ( tiny.size(), static_cast<size_t>(n) );
+
+    // The same entries, stored in the lists.
+    Table spilled( tiny );
+    ASSERT_TRUE( spilled.insert( -1, "extra" ) );
+    ASSERT_FALSE( spilled.is_inline() );
+    ASSERT_TRUE( spilled.erase( -1 ) );
+
+    // Both layouts report the same buckets.
+    std::stringstream inline_out, spilled_out;
+    inline_out << tiny;
+    spilled_out << spilled;
+    ASSERT_EQ( inline_out.str(), spilled_out.str() );
+    for( int i{0}; i < n; ++i )
+        ASSERT_EQ( tiny.count( i * 17 + i % 2 ), spilled.count( i * 17 + i % 2 ) );
+
+    // Erasing keeps the other inline entries reachable.
+    ASSERT_TRUE( tiny.erase( 18 ) );
+    ASSERT_FALSE( tiny.erase( 18 ) );
+    std::string data;
+    for( int i{2}; i < n; ++i )
+        ASSERT_TRUE( tiny.retrieve( i * 17 + i % 2, data ) );
+    tiny[ 1000 ] = "thousand";
+    ASSERT_EQ( tiny.at( 1000 ), "thousand" );
+    ASSERT_TRUE( tiny.is_inline() );
+
+    // Assignment copies the layout of the source.
+    spilled = tiny;
+    ASSERT_TRUE( spilled.is_inline() );
+    ASSERT_EQ( spilled.size(), tiny.size() );
+    tiny.clear();
+    ASSERT_TRUE( tiny.empty() );
+    ASSERT_EQ( spilled.at( 1000 ), "thousand" );
+}
+
+TEST_F(HTTest, ConcurrentTransfers)
+{
+    ConcurrentAccounts bank;
+    for( auto & e : m_accounts )
+        ASSERT_TRUE( bank.insert( e ) );
+    const double total = bank.total_balance();
+
+    // Several threads move money around at the same time.
+    std::vector< std::thread > workers;
+    for( unsigned t{0}; t < 4; ++t )
+        workers.emplace_back( [&, t] {
+            for( unsigned i{0}; i < 5000; ++i )
+            {
+                auto & from = m_accounts[ ( i + t ) % m_accounts.size() ];
+                auto & to = m_accounts[ ( i * 3 + t + 1 ) % m_accounts.size() ];
+                bank.transfer( from.getKey(), to.getKey(), 0.25f );
+            }
+        } );
+    for( auto & w : workers )
+        w.join();
+    ASSERT_NEAR( bank.total_balance(), total, 0.01 );
+    ASSERT_EQ( bank.size(), m_accounts.size() );
+
+    // Not enough funds: nothing changes.
+    Account before, after;
+    bank.retrieve( m_accounts[0].getKey(), before );
+    ASSERT_FALSE( bank.transfer( m_accounts[0].getKey(), m_accounts[1].getKey(), before.m_balance + 1 ) );
+    bank.retrieve( m_accounts[0].getKey(), after );
+    ASSERT_EQ( before.m_balance, after.m_balance );
+    ASSERT_FALSE( bank.transfer( m_accounts[0].getKey(), Account{ "Nobody" }.getKey(), 1 ) );
+
+    // Only positive, finite amounts are moved.
+    ASSERT_FALSE( bank.transfer( m_accounts[0].getKey(), m_accounts[1].getKey(), -1 ) );
+    ASSERT_FALSE( bank.transfer( m_accounts[0].getKey(), m_accounts[1].getKey(), 0 ) );
+    ASSERT_FALSE( bank.transfer( m_accounts[0].getKey(), m_accounts[1].getKey(), std::nanf( "" ) ) );
+    ASSERT_FALSE( bank.transfer( m_accounts[0].getKey(), m_accounts[0].getKey(), -1 ) );
+    bank.retrieve( m_accounts[0].getKey(), after );
+    ASSERT_EQ( before.m_balance, after.m_balance );
+    ASSERT_NEAR( bank.total_balance(), total, 0.01 );
+
+    // An aborted transaction leaves no trace, even after changing the copies.
+    std::vector< Account::AcctKey > keys{ m_accounts[2].getKey(), m_accounts[3].getKey(), m_accounts[4].getKey() };
+    ASSERT_FALSE( bank.transact( keys, []( std::vector< Account > & accts ) {
+        for( auto & a : accts )
+            a.m_balance = 0;
+        return false;
+    } ) );
+    ASSERT_NEAR( bank.total_balance(), total, 0.01 );
+
+    // A committed one changes all the accounts at once.
+    ASSERT_TRUE( bank.transact( keys, []( std::vector< Account > & accts ) {
+        for( auto & a : accts )
+            a.m_balance += 10;
+        return true;
+    } ) );
+    ASSERT_NEAR( bank.total_balance(), total + 30, 0.01 );
+
+    ASSERT_TRUE( bank.erase( keys[0] ) );
+    ASSERT_FALSE( bank.transact( keys, []( std::vector< Account > & ) { return true; } ) );
+}
+
+TEST_F(HTTest, LatencyHistogram)
+{
+    ac::LatencyHistogram h;
+    ASSERT_EQ( h.percentile( 50 ), 0u );
+
+    // 1..100000 ns, once each.
+    for( uint64_t v{1}; v <= 100000; ++v )
+        h.record( v );
+    ASSERT_EQ( h.count(), 100000u );
+    ASSERT_EQ( h.max(), 100000u );
+
+    // Percentiles within the relative error of the buckets.
+    for( double p : { 1.0, 50.0, 99.0, 99.9 } )
+    {
+        double exact = p * 1000;
+        ASSERT_NEAR( static_cast<double>( h.percentile( p ) ), exact, exact / 64 + 1 );
+    }
+    ASSERT_EQ( h.percentile( 100 ), 100000u );
+    // Small values are exact.
+    ac::LatencyHistogram small;
+    small.record( 7 );
+    small.record( 9 );
+    ASSERT_EQ( small.percentile( 50 ), 7u );
+
+    // Merging is the same as recording everything in one histogram.
+    ac::LatencyHistogram a, b;
+    for( uint64_t v{1}; v <= 100000; ++v )
+        ( v % 2 ? a : b ).record( v );
+    a.merge( b );
+    ASSERT_EQ( a.count(), h.count() );
+    for( double p : { 50.0, 99.0, 99.9 } )
+        ASSERT_EQ( a.percentile( p ), h.percentile( p ) );
+
+    // Huge values are clamped, not lost.
+    h.record( uint64_t{1} << 50 );
+    ASSERT_EQ( h.count(), 100001u );
+}
+
+TEST_F(HTTest, HashTblStatsPerThread)
+{
+    ac::HashTblStats::reset();
+
+    // What AC_HASHTBL_INSTRUMENT does inside each HashTbl operation.
+    auto work = [] {
+        for( int i{0}; i < 1000; ++i )
+        {
+            ac::OpTimer timer{ ac::HashTblOp::INSERT };
+        }
+        ac::OpTimer timer{ ac::HashTblOp::ERASE };
+    };
+    std::thread other( work );
+    work();
+    other.join();
+
+    // The histograms of the finished thread are kept.
+    auto stats = ac::HashTblStats::snapshot();
+    ASSERT_EQ( stats[ static_cast<size_t>( ac::HashTblOp::INSERT ) ].count(), 2000u );
+    ASSERT_EQ( stats[ static_cast<size_t>( ac::HashTblOp::ERASE ) ].count(), 2u );
+    ASSERT_EQ( stats[ static_cast<size_t>( ac::HashTblOp::RETRIEVE ) ].count(), 0u );
+
+    ac::HashTblStats::reset();
+    ASSERT_EQ( ac::HashTblStats::snapshot()[0].count(), 0u );
+}
+
+TEST_F(HTTest, TwoChoiceShortChains)
+{
+    // A well-mixed hash, so the single hash table sees random placement too.
+    struct MixedHash {
+        size_t operator()( int k ) const { return ac::mix64( static_cast< uint64_t >( k ) ); }
+    };
+
+    const int N{ 100000 };
+    ac::TwoChoiceTbl< int, int, MixedHash > two;
+    ac::HashTbl< int, int, MixedHash > one;
+    for( int i{0}; i < N; ++i )
+    {
+        ASSERT_TRUE( two.insert( i * 7919, i ) );
+        one.insert( i * 7919, i );
+    }
+    ASSERT_EQ( two.size(), size_t(N) );
+    ASSERT_FALSE( two.insert( 0, -1 ) );
+    ASSERT_EQ( two.at( 0 ), -1 );
+
+    // Every key is found in one of its two buckets, also after the rehashes.
+    int data;
+    for( int i{1}; i < N; ++i )
+    {
+        ASSERT_TRUE( two.retrieve( i * 7919, data ) );
+        ASSERT_EQ( data, i );
+    }
+    ASSERT_FALSE( two.retrieve( 1, data ) );
+    ASSERT_THROW( two.at( 1 ), std::out_of_range );
+
+    // The longest chain is much shorter than with a single hash.
+    size_t longest{0};
+    for( int i{0}; i < N; ++i )
+        longest = std::max( longest, one.count( i * 7919 ) );
+    ASSERT_LE( two.max_chain_length(), 5u );
+    ASSERT_LT( two.max_chain_length(), longest );
+
+    for( int i{0}; i < N; i += 2 )
+        ASSERT_TRUE( two.erase( i * 7919 ) );
+    ASSERT_FALSE( two.erase( 0 ) );
+    ASSERT_EQ( two.size(), size_t(N / 2) );
+    ASSERT_FALSE( two.retrieve( 2 * 7919, data ) );
+    two[ 2 * 7919 ] += 5;
+    ASSERT_EQ( two.at( 2 * 7919 ), 5 );
+
+    two.clear();
+    ASSERT_TRUE( two.empty() );
+    ASSERT_EQ( two.max_chain_length(), 0u );
+}
+
+TEST_F(HTTest, TwoChoiceSeededHash)
+{
+    // Every key has the same unseeded hash, but the seeded calls tell them apart.
+    struct SeededHash {
+        size_t operator()( int ) const { return 42; }
+        size_t operator()( int k, uint64_t seed ) const { return ac::mix64( static_cast< uint64_t >( k ), seed ); }
+    };
+
+    const int N{ 10000 };
+    ac::TwoChoiceTbl< int, int, SeededHash > two;
+    for( int i{0}; i < N; ++i )
+        ASSERT_TRUE( two.insert( i, i ) );
+
+    int data;
+    for( int i{0}; i < N; ++i )
+    {
+        ASSERT_TRUE( two.retrieve( i, data ) );
+        ASSERT_EQ( data, i );
+    }
+    ASSERT_LE( two.max_chain_length(), 5u );
+}
+
+TEST_F(HTTest, DiskExtendibleHashing)
+{
+    using Table = ac::DiskHashTbl< int, long >;
+    const std::string path{ "/tmp/ac_disk_test_" + std::to_string( getpid() ) };
+    Table::remove( path );
+
+    const int N{ 20000 };
+    {
+        // A tiny cache, so most pages come and go from the file.
+        Table table = Table::create( path, 4 );
+        ASSERT_THROW( Table::create( path ), std::runtime_error );
+        for( int i{0}; i < N; ++i )
+            ASSERT_TRUE( table.insert( i, i * 10L ) );
+        ASSERT_FALSE( table.insert( 7, 70L ) );
+        ASSERT_EQ( table.size(), size_t(N) );
+
+        // The pages were split locally: fewer pages than directory slots.
+        ASSERT_GT( table.page_count(), 1u );
+        ASSERT_LE( table.page_count(), size_t{1} << table.global_depth() );
+
+        for( int i{0}; i < N; i += 2 )
+            ASSERT_TRUE( table.erase( i ) );
+        ASSERT_FALSE( table.erase( 0 ) );
+        ASSERT_EQ( table.size(), size_t(N / 2) );
+    }
+
+    // The table survives in the file, and a lookup reads at most one page.
+    Table table = Table::open( path, 2 );
+    ASSERT_EQ( table.size(), size_t(N / 2) );
+    long data;
+    for( int i{0}; i < N; ++i )
+    {
+        size_t before = table.page_reads();
+        ASSERT_EQ( table.retrieve( i, data ), i % 2 == 1 );
+        if( i % 2 == 1 )
+        {
+            ASSERT_EQ( data, i * 10L );
+        }
+        ASSERT_LE( table.page_reads() - before, 1u );
+    }
+
+    long sum{0};
+    table.for_each( [&]( int, long d ) { sum += d; } );
+    ASSERT_EQ( sum, 10L * ( N / 2 ) * ( N / 2 ) );
+
+    Table::remove( path );
+    ASSERT_THROW( Table::open( path ), std::runtime_error );
+}
+
+TEST_F(HTTest, DiskEqualHashes)
+{
+    struct Same { std::size_t operator()( int ) const { return 42; } };
+    using Table = ac::DiskHashTbl< int, long, Same >;
+    const std::string path{ "/tmp/ac_disk_same_" + std::to_string( getpid() ) };
+    Table::remove( path );
+
+    // A page of equal hashes fails at once, without growing the directory.
+    {
+        Table table = Table::create( path );
+        int i{0};
+        ASSERT_THROW( { for( ;; ++i ) table.insert( i, i ); }, std::length_error );
+        ASSERT_GT( i, 1 );
+        ASSERT_EQ( table.size(), size_t(i) );
+        ASSERT_EQ( table.global_depth(), 0u );
+        ASSERT_EQ( table.page_count(), 1u );
+    }
+    Table::remove( path );
+}
+
+TEST_F(HTTest, StripedHotCounters)
+{
+    // Threads add to their own slots; the sum is exact.
+    ac::StripedCounter< long > c{ 4 };
+    ASSERT_EQ( c.slots(), 4u );
+    std::vector< std::thread > adders;
+    for( int t{0}; t < 4; ++t )
+        adders.emplace_back( [&] { for( int i{0}; i < 10000; ++i ) c.add( 1 ); } );
+    for( auto & a : adders )
+        a.join();
+    ASSERT_EQ( c.load(), 40000 );
+    ASSERT_EQ( c.drain(), 40000 );
+    ASSERT_EQ( c.load(), 0 );
+
+    ConcurrentAccounts bank;
+    for( auto & e : m_accounts )
+        bank.insert( e );
+    const double total = bank.total_balance();
+    auto merchant = m_accounts[0].getKey();
+    ASSERT_TRUE( bank.make_hot( merchant ) );
+    ASSERT_FALSE( bank.make_hot( merchant ) );
+    ASSERT_FALSE( bank.make_hot( Account{ "Nobody" }.getKey() ) );
+    ASSERT_FALSE( bank.erase( merchant ) );
+
+    Account before;
+    bank.retrieve( merchant, before );
+
+    // Many payments to the hot account at once; no money is lost.
+    std::atomic< unsigned > paid{ 0 };
+    std::vector< std::thread > payers;
+    for( unsigned t{0}; t < 4; ++t )
+        payers.emplace_back( [&, t] {
+            for( unsigned i{0}; i < 2000; ++i )
+                if( bank.transfer( m_accounts[ 1 + ( i + t ) % ( m_accounts.size() - 1 ) ].getKey(), merchant, 0.25f ) )
+                    ++paid;
+        } );
+    for( auto & p : payers )
+        p.join();
+    ASSERT_GT( paid.load(), 0u );
+    ASSERT_NEAR( bank.total_balance(), total, 0.01 );
+
+    // Reads include the pending credits, before and after they are folded.
+    const float income = paid * 0.25f;
+    Account now;
+    bank.retrieve( merchant, now );
+    ASSERT_NEAR( now.m_balance, before.m_balance + income, 0.01 );
+    ASSERT_TRUE( bank.credit( merchant, 5 ) );
+    ASSERT_FALSE( bank.credit( merchant, -5 ) );
+    ASSERT_FALSE( bank.credit( merchant, std::nanf( "" ) ) );
+    bank.fold_hot();
+    bank.retrieve( merchant, now );
+    ASSERT_NEAR( now.m_balance, before.m_balance + income + 5, 0.01 );
+
+    // A debit sees the folded balance.
+    ASSERT_TRUE( bank.transfer( merchant, m_accounts[1].getKey(), before.m_balance + income ) );
+    ASSERT_TRUE( bank.make_cold( merchant ) );
+    ASSERT_FALSE( bank.make_cold( merchant ) );
+    bank.retrieve( merchant, now );
+    ASSERT_NEAR( now.m_balance, 5, 0.01 );
+    ASSERT_NEAR( bank.total_balance(), total + 5, 0.01 );
+}
+
+TEST_F(HTTest, HotKeyCache)
+{
+    ac::HashTbl< int, int > ht;
+    ASSERT_EQ( ht.hot_cache(), 0u );
+    ht.hot_cache( 50 );
+    ASSERT_EQ( ht.hot_cache(), 64u );
+
+    for( int i{0}; i < 1000; ++i )
+        ht.insert( i, i );
+
+    // Hits, misses and updates of cached keys, also across rehashes.
+    int data;
+    for( int round{0}; round < 3; ++round )
+        for( int i{0}; i < 1000; i += 7 )
+        {
+            ASSERT_TRUE( ht.retrieve( i, data ) );
+            ASSERT_EQ( data, i + round * 10 );
+            ht.at( i ) += 5;
+            ht[ i ] += 5;
+        }
+    for( int i{1000}; i < 5000; ++i )
+        ht.insert( i, i );
+    ASSERT_TRUE( ht.retrieve( 7, data ) );
+    ASSERT_EQ( data, 37 );
+    ASSERT_FALSE( ht.insert( 7, -7 ) );
+    ASSERT_EQ( ht.at( 7 ), -7 );
+    ASSERT_FALSE( ht.retrieve( 5000, data ) );
+
+    // An erased key is no longer found through the cache.
+    ASSERT_TRUE( ht.erase( 7 ) );
+    ASSERT_FALSE( ht.retrieve( 7, data ) );
+    ASSERT_THROW( ht.at( 7 ), std::out_of_range );
+    ASSERT_EQ( ht[ 7 ], 0 );
+
+    // Copies get an empty cache of their own.
+    ac::HashTbl< int, int > copy{ ht };
+    ASSERT_EQ( copy.hot_cache(), 64u );
+    copy.at( 14 ) = 1;
+    ASSERT_EQ( ht.at( 14 ), 44 );
+    // The const at() returns a reference to the stored data, or throws.
+    const auto & const_ht = ht;
+    ASSERT_EQ( &const_ht.at( 14 ), &ht.at( 14 ) );
+    ASSERT_THROW( const_ht.at( -1 ), std::out_of_range );
+    ASSERT_EQ( copy.at( 14 ), 1 );
+
+    ht.clear();
+    ASSERT_FALSE( ht.retrieve( 14, data ) );
+    ht.hot_cache( 0 );
+    ASSERT_EQ( ht.hot_cache(), 0u );
+    ht.insert( 14, 2 );
+    ASSERT_EQ( ht.at( 14 ), 2 );
+}
+
+TEST_F(HTTest, BlockBuckets)
+{
+    ac::BlockHashTbl< int, int > ht;
+    const int N{ 50000 };
+    for( int i{0}; i < N; ++i )
+        ASSERT_TRUE( ht.insert( i, i ) );
+    ASSERT_FALSE( ht.insert( 3, 33 ) );
+    ASSERT_EQ( ht.size(), size_t(N) );
+    ASSERT_LE( ht.size(), ht.bucket_count() * ht.max_load_factor() );
+
+    // A few buckets overflow their block, but most do not.
+    ASSERT_LT( ht.overflow_blocks(), ht.bucket_count() / 10 );
+
+    int data;
+    for( int i{0}; i < N; ++i )
+    {
+        ASSERT_TRUE( ht.retrieve( i, data ) );
+        ASSERT_EQ( data, i == 3 ? 33 : i );
+    }
+    ASSERT_FALSE( ht.retrieve( N, data ) );
+    ASSERT_THROW( ht.at( N ), std::out_of_range );
+
+    // Erasing moves entries and slots around; every other key is still found.
+    for( int i{0}; i < N; i += 2 )
+        ASSERT_TRUE( ht.erase( i ) );
+    ASSERT_FALSE( ht.erase( 0 ) );
+    ASSERT_EQ( ht.size(), size_t(N / 2) );
+    for( int i{0}; i < N; ++i )
+        ASSERT_EQ( ht.retrieve( i, data ), i % 2 == 1 );
+    long sum{0};
+    ht.for_each( [&]( const auto & e ) { sum += e.m_key; } );
+    ASSERT_EQ( sum, long(N / 2) * long(N / 2) );
+
+    // A crowded table chains overflow blocks and frees them again.
+    ac::BlockHashTbl< int, int > crowded{ 4 };
+    crowded.max_load_factor( 100 );
+    for( int i{0}; i < 300; ++i )
+        crowded[ i ] = i;
+    ASSERT_EQ( crowded.bucket_count(), 4u );
+    ASSERT_GT( crowded.overflow_blocks(), 0u );
+    for( int i{0}; i < 300; ++i )
+        ASSERT_EQ( crowded.at( i ), i );
+    for( int i{0}; i < 300; ++i )
+        ASSERT_TRUE( crowded.erase( i ) );
+    ASSERT_TRUE( crowded.empty() );
+    ASSERT_EQ( crowded.overflow_blocks(), 0u );
+
+    ht.clear();
+    ASSERT_TRUE( ht.empty() );
+    ASSERT_FALSE( ht.retrieve( 1, data ) );
+}
+
+TEST_F(HTTest, CollisionFloodReseed)
+{
+    // SipHash-2-4 of the empty message, with the key 00 01 .. 0f of the reference test vectors.
+    ASSERT_EQ( ac::siphash24( "", 0, 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL ), 0x726fdb47dd0e0e31ULL );
+
+    // Keys whose unseeded hashes are all equal: same name, and bank ^ branch ^ number == 0.
+    ac::HashTbl< Account::AcctKey, int, KeyHash, KeyEqual > accounts;
+    ASSERT_EQ( accounts.chain_limit(), 64u );
+    for( int i{0}; i < 1000; ++i )
+        accounts.insert( std::make_tuple( std::string{ "Mallory" }, i, i, 0 ), i );
+    for( int i{1000}; i < 2000; ++i )
+        accounts[ std::make_tuple( std::string{ "Mallory" }, i, i, 0 ) ] = i;
+    // The keyed hash spreads them: one reseed is enough.
+    ASSERT_EQ( accounts.reseeds(), 1u );
+    ASSERT_EQ( accounts.chain_limit(), 64u );
+    ASSERT_EQ( accounts.size(), 2000u );
+    int data;
+    for( int i{0}; i < 2000; ++i )
+    {
+        ASSERT_TRUE( accounts.retrieve( std::make_tuple( std::string{ "Mallory" }, i, i, 0 ), data ) );
+        ASSERT_EQ( data, i );
+    }
+    // The list of a key depends on the random seed, but is no longer than the limit.
+    ASSERT_LE( accounts.count( std::make_tuple( std::string{ "Mallory" }, 3, 3, 0 ) ), accounts.chain_limit() );
+    ASSERT_TRUE( accounts.erase( std::make_tuple( std::string{ "Mallory" }, 3, 3, 0 ) ) );
+    ASSERT_FALSE( accounts.retrieve( std::make_tuple( std::string{ "Mallory" }, 3, 3, 0 ), data ) );
+
+    // A copy hashes with the same seed.
+    auto copy{ accounts };
+    ASSERT_TRUE( copy.retrieve( std::make_tuple( std::string{ "Mallory" }, 1999, 1999, 0 ), data ) );
+    ASSERT_EQ( data, 1999 );
+
+    // Without a seeded overload, equal hashes stay together: the limit grows instead of reseeding on every insertion.
+    struct CoarseHash {
+        std::size_t operator()( int key ) const { return static_cast< std::size_t >( key / 200 ); }
+    };
+    ac::HashTbl< int, int, CoarseHash > coarse;
+    for( int i{0}; i < 2000; ++i )
+        coarse.insert( i, -i );
+    ASSERT_GE( coarse.reseeds(), 1u );
+    ASSERT_LE( coarse.reseeds(), 3u );
+    ASSERT_GE( coarse.chain_limit(), 200u );
+    for( int i{0}; i < 2000; ++i )
+        ASSERT_EQ( coarse.at( i ), -i );
+
+    // Long lists are expected under a high maximum load factor, and do not trigger reseeds.
+    ac::HashTbl< int, int > dense;
+    dense.max_load_factor( 100 );
+    for( int i{0}; i < 20000; ++i )
+        dense.insert( i, i );
+    ASSERT_EQ( dense.reseeds(), 0u );
+    ASSERT_EQ( dense.at( 12345 ), 12345 );
+
+    // The monitoring can be disabled.
+    ac::HashTbl< int, int, CoarseHash > unmonitored;
+    unmonitored.chain_limit( 0 );
+    for( int i{0}; i < 2000; ++i )
+        unmonitored.insert( i, i );
+    ASSERT_EQ( unmonitored.reseeds(), 0u );
+}
+
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);